@@ -0,0 +1,121 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Throughput of embedids_analyze_all over hundreds of metrics
+ *
+ * Built against a copy of the library with EMBEDIDS_MAX_METRICS raised to
+ * its limit. Every metric holds a full ring and one threshold algorithm
+ * that never fires, so each pass visits every metric. The cold figures
+ * evict the caches before each pass, as when analysis runs on a timer
+ * between unrelated work, and show how many cache lines a pass touches.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "embedids.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_POINTS 8u
+#define TARGET_METRIC_VISITS 20000000u
+#define COLD_PASSES 200u
+#define EVICT_BYTES (32u * 1024u * 1024u)
+
+static embedids_metric_config_t metrics[EMBEDIDS_MAX_METRICS];
+static embedids_metric_datapoint_t history[EMBEDIDS_MAX_METRICS][RING_POINTS];
+static volatile uint8_t evict_buffer[EVICT_BYTES];
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void evict_caches(void) {
+  for (uint32_t i = 0; i < EVICT_BYTES; i += 64) {
+    evict_buffer[i]++;
+  }
+}
+
+/* Time analyze_all on a set-up context; cold passes evict caches first */
+static double time_passes(embedids_context_t *context, uint32_t passes, bool cold) {
+  double total = 0.0;
+  for (uint32_t pass = 0; pass < passes; pass++) {
+    if (cold) {
+      evict_caches();
+    }
+    double start = now_ns();
+    if (embedids_analyze_all(context) != EMBEDIDS_OK) {
+      return 0.0;
+    }
+    total += now_ns() - start;
+  }
+  return total / passes;
+}
+
+static void bench_analyze_all(uint32_t num_metrics, double *warm, double *cold) {
+  embedids_context_t context;
+  embedids_system_config_t system;
+  memset(&context, 0, sizeof(context));
+  memset(&system, 0, sizeof(system));
+  memset(metrics, 0, sizeof(metrics));
+
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    embedids_metric_config_t *config = &metrics[i];
+    snprintf(config->metric.name, EMBEDIDS_MAX_METRIC_NAME_LEN, "device.sensor.%03u", i);
+    config->metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    config->metric.history = history[i];
+    config->metric.max_history_size = RING_POINTS;
+    config->metric.enabled = true;
+    config->num_algorithms = 1;
+    config->algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    config->algorithms[0].enabled = true;
+    config->algorithms[0].config.threshold.max_threshold.u32 = UINT32_MAX;
+    config->algorithms[0].config.threshold.check_max = true;
+  }
+  system.metrics = metrics;
+  system.max_metrics = num_metrics;
+  system.num_active_metrics = num_metrics;
+  if (embedids_init(&context, &system) != EMBEDIDS_OK) {
+    *warm = *cold = 0.0;
+    return;
+  }
+
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    for (uint32_t p = 0; p < RING_POINTS; p++) {
+      value.u32 = p;
+      embedids_add_datapoint(&context, metrics[i].metric.name, value, p);
+    }
+  }
+
+  *warm = time_passes(&context, TARGET_METRIC_VISITS / num_metrics, false);
+  *cold = time_passes(&context, COLD_PASSES, true);
+}
+
+int main(void) {
+  printf("EmbedIDS analyze_all benchmark (%u-point rings, %zu-byte metric configs)\n\n",
+         RING_POINTS, sizeof(embedids_metric_config_t));
+  printf("metrics   warm ns/pass  ns/metric   cold ns/pass  ns/metric\n");
+  for (uint32_t n = 32; n <= EMBEDIDS_MAX_METRICS; n *= 2) {
+    double warm = 0.0;
+    double cold = 0.0;
+    bench_analyze_all(n, &warm, &cold);
+    printf("%7u %14.1f %10.2f %14.1f %10.2f\n", n, warm, warm / n, cold, cold / n);
+  }
+  return 0;
+}
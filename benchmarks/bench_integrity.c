@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of history integrity checksums
+ *
+ * Measures CRC32C throughput, ingest with and without block checksums,
+ * and analysis with the lazy verification it adds.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_POINTS 1024u
+#define INGEST_POINTS 2000000u
+#define ANALYSIS_PASSES 20000u
+#define CRC_BYTES (64u * 1024u)
+#define CRC_ROUNDS 2000u
+
+static embedids_metric_datapoint_t history[RING_POINTS];
+static uint32_t block_crcs[EMBEDIDS_INTEGRITY_BLOCKS(RING_POINTS)];
+static uint8_t crc_buffer[CRC_BYTES];
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void setup(embedids_context_t *context, embedids_system_config_t *system,
+                  embedids_metric_config_t *config, bool checksums) {
+  memset(context, 0, sizeof(*context));
+  memset(system, 0, sizeof(*system));
+  memset(config, 0, sizeof(*config));
+  strncpy(config->metric.name, "bench", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+  config->metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+  config->metric.history = history;
+  config->metric.block_crcs = checksums ? block_crcs : NULL;
+  config->metric.max_history_size = RING_POINTS;
+  config->metric.enabled = true;
+  config->num_algorithms = 1;
+  config->algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  config->algorithms[0].enabled = true;
+  config->algorithms[0].config.threshold.max_threshold.u32 = UINT32_MAX;
+  config->algorithms[0].config.threshold.check_max = true;
+  system->metrics = config;
+  system->max_metrics = 1;
+  system->num_active_metrics = 1;
+  embedids_init(context, system);
+}
+
+static void bench_crc(void) {
+  for (uint32_t i = 0; i < CRC_BYTES; i++) {
+    crc_buffer[i] = (uint8_t)(i * 31u);
+  }
+
+  uint32_t sink = 0;
+  double start = now_ns();
+  for (uint32_t r = 0; r < CRC_ROUNDS; r++) {
+    sink ^= embedids_crc32c_portable(sink, crc_buffer, CRC_BYTES);
+  }
+  double portable = now_ns() - start;
+
+  start = now_ns();
+  for (uint32_t r = 0; r < CRC_ROUNDS; r++) {
+    sink ^= embedids_crc32c(sink, crc_buffer, CRC_BYTES);
+  }
+  double selected = now_ns() - start;
+
+  double bytes = (double)CRC_BYTES * CRC_ROUNDS;
+  printf("crc32c portable        %8.1f MB/s\n", bytes / portable * 1e3);
+  printf("crc32c %-15s %8.1f MB/s\n",
+         embedids_crc32c_accelerated() ? "hardware" : "(no hardware)",
+         bytes / selected * 1e3);
+  if (sink == 0x12345678u) {
+    printf("\n"); // Keep the loops from being optimized away
+  }
+}
+
+static double bench_ingest(bool checksums) {
+  embedids_context_t context;
+  embedids_system_config_t system;
+  embedids_metric_config_t config;
+  setup(&context, &system, &config, checksums);
+
+  embedids_u32_handle_t handle;
+  embedids_get_u32_handle(&context, "bench", &handle);
+  double start = now_ns();
+  for (uint32_t i = 0; i < INGEST_POINTS; i++) {
+    embedids_add_u32(&handle, i, i);
+  }
+  return (now_ns() - start) / INGEST_POINTS;
+}
+
+static double bench_analysis(bool checksums) {
+  embedids_context_t context;
+  embedids_system_config_t system;
+  embedids_metric_config_t config;
+  setup(&context, &system, &config, checksums);
+
+  embedids_u32_handle_t handle;
+  embedids_get_u32_handle(&context, "bench", &handle);
+  for (uint32_t i = 0; i < RING_POINTS; i++) {
+    embedids_add_u32(&handle, i, i);
+  }
+
+  double start = now_ns();
+  for (uint32_t i = 0; i < ANALYSIS_PASSES; i++) {
+    embedids_analyze_metric(&context, "bench");
+  }
+  return (now_ns() - start) / ANALYSIS_PASSES;
+}
+
+int main(void) {
+  printf("EmbedIDS integrity benchmark (%u-point ring, %u points per block)\n\n",
+         RING_POINTS, (unsigned)EMBEDIDS_INTEGRITY_BLOCK_POINTS);
+  bench_crc();
+
+  double ingest_off = bench_ingest(false);
+  double ingest_on = bench_ingest(true);
+  printf("ingest   without crc   %8.1f ns/point\n", ingest_off);
+  printf("ingest   with crc      %8.1f ns/point\n", ingest_on);
+
+  double analysis_off = bench_analysis(false);
+  double analysis_on = bench_analysis(true);
+  printf("analysis without crc   %8.1f ns/pass\n", analysis_off);
+  printf("analysis with crc      %8.1f ns/pass\n", analysis_on);
+  return 0;
+}
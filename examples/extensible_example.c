@@ -11,8 +11,6 @@
 typedef struct {
     float baseline;
     float threshold_multiplier;
-    uint32_t consecutive_violations;
-    uint32_t max_violations;
 } pattern_detector_context_t;
 
 // Custom algorithm: Advanced pattern detection
@@ -26,31 +24,24 @@ embedids_result_t advanced_pattern_detector(const embedids_metric_t* metric,
         return EMBEDIDS_OK; // Need at least 3 data points
     }
     
-    // Get the last few data points
-    uint32_t idx1 = (metric->write_index - 1) % metric->max_history_size;
-    uint32_t idx2 = (metric->write_index - 2) % metric->max_history_size;
-    uint32_t idx3 = (metric->write_index - 3) % metric->max_history_size;
-    
-    float val1 = metric->history[idx1].value.f32;
-    float val2 = metric->history[idx2].value.f32;
-    float val3 = metric->history[idx3].value.f32;
+    // Average the last three data points, read in place from the ring
+    embedids_datapoint_span_t recent;
+    embedids_metric_window(metric, 3, &recent);
+    float sum = 0.0f;
+    EMBEDIDS_SPAN_FOREACH(&recent, point) {
+        sum += point->value.f32;
+    }
     
     // Calculate variance from baseline
-    float avg_recent = (val1 + val2 + val3) / 3.0f;
+    float avg_recent = sum / 3.0f;
     float deviation = fabs(avg_recent - ctx->baseline);
     
+    // Every violation is reported; the metric's alert rule decides when a
+    // run of them is sustained enough to alert
     if (deviation > ctx->baseline * ctx->threshold_multiplier) {
-        ctx->consecutive_violations++;
-        printf("    [PATTERN] High deviation %.2f from baseline %.2f (violation %d/%d)\n", 
-               deviation, ctx->baseline, ctx->consecutive_violations, ctx->max_violations);
-        
-        if (ctx->consecutive_violations >= ctx->max_violations) {
-            printf("    [ALERT] PATTERN ALERT: Sustained anomalous behavior detected!\n");
-            ctx->consecutive_violations = 0; // Reset counter
-            return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-        }
-    } else {
-        ctx->consecutive_violations = 0; // Reset on normal reading
+        printf("    [PATTERN] High deviation %.2f from baseline %.2f\n",
+               deviation, ctx->baseline);
+        return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
     }
     
     return EMBEDIDS_OK;
@@ -66,14 +57,16 @@ embedids_result_t rate_change_detector(const embedids_metric_t* metric,
         return EMBEDIDS_OK;
     }
     
-    // Get last two data points
-    uint32_t idx1 = (metric->write_index - 1) % metric->max_history_size;
-    uint32_t idx2 = (metric->write_index - 2) % metric->max_history_size;
+    // Get last two data points; the window handles wraparound
+    embedids_datapoint_span_t recent;
+    embedids_metric_window(metric, 2, &recent);
+    const embedids_metric_datapoint_t *newest = EMBEDIDS_SPAN_AT(&recent, 1);
+    const embedids_metric_datapoint_t *previous = EMBEDIDS_SPAN_AT(&recent, 0);
     
-    float val1 = metric->history[idx1].value.f32;
-    float val2 = metric->history[idx2].value.f32;
-    uint64_t time1 = metric->history[idx1].timestamp_ms;
-    uint64_t time2 = metric->history[idx2].timestamp_ms;
+    float val1 = newest->value.f32;
+    float val2 = previous->value.f32;
+    uint64_t time1 = newest->timestamp_ms;
+    uint64_t time2 = previous->timestamp_ms;
     
     if (time1 == time2) return EMBEDIDS_OK; // Avoid division by zero
     
@@ -137,17 +130,28 @@ int main(void) {
     // Custom algorithm contexts
     pattern_detector_context_t cpu_pattern_ctx = {
         .baseline = 35.0f,
-        .threshold_multiplier = 0.8f,
-        .consecutive_violations = 0,
-        .max_violations = 3
+        .threshold_multiplier = 0.8f
     };
     
     pattern_detector_context_t memory_pattern_ctx = {
         .baseline = 50.0f,
-        .threshold_multiplier = 0.6f,
-        .consecutive_violations = 0,
-        .max_violations = 2
+        .threshold_multiplier = 0.6f
+    };
+    
+    // Pattern alerts need consecutive violations (3 on CPU, 2 on memory),
+    // report once per episode and re-arm after two normal readings
+    embedids_alert_rule_t cpu_pattern_rule = {
+        .raise_after = 3, .clear_after = 2, .report_once = true
+    };
+    embedids_alert_rule_t memory_pattern_rule = {
+        .raise_after = 2, .clear_after = 2, .report_once = true
     };
+    embedids_alert_state_t cpu_alerts[3];
+    embedids_alert_state_t memory_alerts[2];
+    memset(cpu_alerts, 0, sizeof(cpu_alerts));
+    memset(memory_alerts, 0, sizeof(memory_alerts));
+    cpu_alerts[1].rule = &cpu_pattern_rule;
+    memory_alerts[1].rule = &memory_pattern_rule;
     
     float cpu_rate_limit = 20.0f; // Max 20% change per second
     float network_rate_limit = 1000.0f; // Max 1000 packets/s change rate
@@ -241,16 +245,19 @@ int main(void) {
     
     // ===== System Configuration =====
     embedids_metric_config_t metric_configs[3];
+    memset(metric_configs, 0, sizeof(metric_configs)); // Unused fields must be zero
     
     // CPU metric config
     metric_configs[0].metric = cpu_metric;
     memcpy(metric_configs[0].algorithms, cpu_algorithms, sizeof(cpu_algorithms));
     metric_configs[0].num_algorithms = 3;
+    metric_configs[0].alerts = cpu_alerts;
     
     // Memory metric config
     metric_configs[1].metric = memory_metric;
     memcpy(metric_configs[1].algorithms, memory_algorithms, sizeof(memory_algorithms));
     metric_configs[1].num_algorithms = 2;
+    metric_configs[1].alerts = memory_alerts;
     
     // Network metric config
     metric_configs[2].metric = network_metric;
@@ -353,6 +360,7 @@ int main(void) {
     printf("   * Used user-managed memory (%.1fKB total)\n", 
            (sizeof(cpu_history) + sizeof(memory_history) + sizeof(network_history)) / 1024.0f);
     printf("   * Combined multiple detection strategies per metric\n");
+    printf("   * Debounced pattern alerts with per-algorithm alert rules\n");
     printf("   * Showed extensible architecture flexibility\n");
     
     // Cleanup
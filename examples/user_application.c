@@ -20,11 +20,9 @@
 #define DEVICE_HISTORY_SIZE 20
 #define NUM_DEVICE_METRICS 4
 
-// User-managed memory buffers for IoT device metrics
-static embedids_metric_datapoint_t temperature_history[DEVICE_HISTORY_SIZE];
-static embedids_metric_datapoint_t humidity_history[DEVICE_HISTORY_SIZE];
-static embedids_metric_datapoint_t power_history[DEVICE_HISTORY_SIZE];
-static embedids_metric_datapoint_t connection_history[DEVICE_HISTORY_SIZE];
+// User-managed memory: one block the history rings are carved from
+static uint8_t ids_memory[NUM_DEVICE_METRICS * EMBEDIDS_ARENA_HISTORY_BYTES(DEVICE_HISTORY_SIZE)]
+    __attribute__((aligned(EMBEDIDS_CACHE_LINE_SIZE)));
 
 // Application-specific data structure
 typedef struct {
@@ -49,11 +47,11 @@ embedids_result_t tampering_detector(const embedids_metric_t* metric,
     }
     
     // Check for rapid temperature or humidity changes that might indicate tampering
-    uint32_t latest = (metric->write_index > 0) ? metric->write_index - 1 : metric->max_history_size - 1;
-    uint32_t prev = (latest > 0) ? latest - 1 : metric->max_history_size - 1;
+    embedids_datapoint_span_t recent;
+    embedids_metric_window(metric, 2, &recent);
     
-    float current_val = metric->history[latest].value.f32;
-    float prev_val = metric->history[prev].value.f32;
+    float current_val = EMBEDIDS_SPAN_AT(&recent, 1)->value.f32;
+    float prev_val = EMBEDIDS_SPAN_AT(&recent, 0)->value.f32;
     
     // Alert if temperature changes by more than 15C or humidity by 30% in one reading
     if (strncmp(metric->name, "temperature", 11) == 0) {
@@ -100,7 +98,6 @@ int main(void) {
     device_metrics[0] = (embedids_metric_config_t) {
         .metric = {
             .type = EMBEDIDS_METRIC_TYPE_FLOAT,
-            .history = temperature_history,
             .max_history_size = DEVICE_HISTORY_SIZE,
             .current_size = 0,
             .write_index = 0,
@@ -137,7 +134,6 @@ int main(void) {
     device_metrics[1] = (embedids_metric_config_t) {
         .metric = {
             .type = EMBEDIDS_METRIC_TYPE_FLOAT,
-            .history = humidity_history,
             .max_history_size = DEVICE_HISTORY_SIZE,
             .current_size = 0,
             .write_index = 0,
@@ -172,7 +168,6 @@ int main(void) {
     device_metrics[2] = (embedids_metric_config_t) {
         .metric = {
             .type = EMBEDIDS_METRIC_TYPE_FLOAT,
-            .history = power_history,
             .max_history_size = DEVICE_HISTORY_SIZE,
             .current_size = 0,
             .write_index = 0,
@@ -196,7 +191,6 @@ int main(void) {
     device_metrics[3] = (embedids_metric_config_t) {
         .metric = {
             .type = EMBEDIDS_METRIC_TYPE_UINT32,
-            .history = connection_history,
             .max_history_size = DEVICE_HISTORY_SIZE,
             .current_size = 0,
             .write_index = 0,
@@ -216,6 +210,15 @@ int main(void) {
         }
     };
 
+    // Carve every history ring from the static block
+    embedids_arena_t arena;
+    if (embedids_arena_init(&arena, ids_memory, sizeof(ids_memory)) != EMBEDIDS_OK ||
+        embedids_arena_alloc_histories(&arena, device_metrics, NUM_DEVICE_METRICS, 0) !=
+            EMBEDIDS_OK) {
+        printf("History buffers do not fit the IDS memory block\n");
+        return EXIT_FAILURE;
+    }
+
     // Initialize EmbedIDS
     embedids_context_t context;
     memset(&context, 0, sizeof(context));
@@ -235,9 +238,7 @@ int main(void) {
     
     printf("IoT Security monitoring initialized successfully!\n");
     printf("Monitoring %d metrics with user-managed memory\n", NUM_DEVICE_METRICS);
-    printf("Memory footprint: %zu bytes\n\n", 
-           sizeof(temperature_history) + sizeof(humidity_history) + 
-           sizeof(power_history) + sizeof(connection_history));
+    printf("Memory footprint: %zu bytes\n\n", arena.used);
     
     // Main monitoring loop
     for (int iteration = 1; iteration <= 12; iteration++) {
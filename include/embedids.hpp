@@ -0,0 +1,783 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EMBEDIDS_HPP
+#define EMBEDIDS_HPP
+
+/**
+ * @brief Compile-time configuration for C++17 consumers
+ *
+ * Metrics and algorithms are declared as constexpr objects at namespace
+ * scope and collected by embedids::Config, which checks them with
+ * static_assert and provides static storage for the matching
+ * embedids_system_config_t and history buffers:
+ *
+ * @code
+ * constexpr auto cpu = embedids::metric("cpu_usage", EMBEDIDS_METRIC_TYPE_PERCENTAGE, 16)
+ *                          .with(embedids::threshold().max(90.0f));
+ * using Device = embedids::Config<cpu>;
+ *
+ * embedids_context_t context{};
+ * Device::init(context);
+ * @endcode
+ *
+ * Metric<T, Capacity> is a standalone typed alternative for C++ code that
+ * keeps its own history; export_to() hands its points to the C API.
+ */
+
+#include "embedids.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace embedids {
+
+namespace detail {
+
+enum class BoundKind : uint8_t { None, Integral, Floating, Boolean };
+
+/**
+ * @brief Threshold bound as written, checked against the metric type later
+ */
+struct Bound {
+  BoundKind kind = BoundKind::None;
+  bool negative = false;           /**< Integral bound below zero */
+  unsigned long long integral = 0; /**< Magnitude of an integral bound */
+  double floating = 0.0;           /**< Bound as double, for any kind */
+
+  template <typename T> static constexpr Bound of(T value) {
+    static_assert(std::is_arithmetic_v<T>, "threshold bounds must be numbers");
+    Bound bound;
+    bound.floating = static_cast<double>(value);
+    if constexpr (std::is_same_v<T, bool>) {
+      bound.kind = BoundKind::Boolean;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      bound.kind = BoundKind::Floating;
+    } else {
+      bound.kind = BoundKind::Integral;
+      bound.negative = value < 0;
+      bound.integral = bound.negative ? 0 : static_cast<unsigned long long>(value);
+    }
+    return bound;
+  }
+};
+
+constexpr std::size_t length(const char *text) {
+  std::size_t n = 0;
+  while (text[n] != '\0') {
+    ++n;
+  }
+  return n;
+}
+
+constexpr bool equal(const char *a, const char *b) {
+  std::size_t i = 0;
+  while (a[i] != '\0' && a[i] == b[i]) {
+    ++i;
+  }
+  return a[i] == b[i];
+}
+
+} // namespace detail
+
+/**
+ * @brief Algorithm declaration; create with threshold(), trend() or custom()
+ */
+struct Algorithm {
+  embedids_algorithm_type_t type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  bool enabled = true;
+  detail::Bound min_bound{};
+  detail::Bound max_bound{};
+  uint32_t window_size = 0;
+  float max_slope = 0.0f;
+  float max_variance = 0.0f;
+  embedids_trend_t expected_trend = EMBEDIDS_TREND_STABLE;
+  embedids_custom_algorithm_fn function = nullptr;
+  void *config = nullptr;
+  void *context = nullptr;
+
+  /** @brief Set the lower threshold bound */
+  template <typename T> constexpr Algorithm min(T value) const {
+    Algorithm next = *this;
+    next.min_bound = detail::Bound::of(value);
+    return next;
+  }
+
+  /** @brief Set the upper threshold bound */
+  template <typename T> constexpr Algorithm max(T value) const {
+    Algorithm next = *this;
+    next.max_bound = detail::Bound::of(value);
+    return next;
+  }
+
+  /** @brief Declare the algorithm but leave it switched off */
+  constexpr Algorithm disabled() const {
+    Algorithm next = *this;
+    next.enabled = false;
+    return next;
+  }
+};
+
+/** @brief Threshold algorithm; add bounds with .min() and .max() */
+constexpr Algorithm threshold() { return Algorithm{}; }
+
+/** @brief Trend algorithm over the last window_size points */
+constexpr Algorithm trend(uint32_t window_size, float max_slope, float max_variance,
+                          embedids_trend_t expected_trend = EMBEDIDS_TREND_STABLE) {
+  Algorithm algorithm;
+  algorithm.type = EMBEDIDS_ALGORITHM_TREND;
+  algorithm.window_size = window_size;
+  algorithm.max_slope = max_slope;
+  algorithm.max_variance = max_variance;
+  algorithm.expected_trend = expected_trend;
+  return algorithm;
+}
+
+/** @brief User-provided algorithm; config and context must have static storage */
+constexpr Algorithm custom(embedids_custom_algorithm_fn function, void *config = nullptr,
+                           void *context = nullptr) {
+  Algorithm algorithm;
+  algorithm.type = EMBEDIDS_ALGORITHM_CUSTOM;
+  algorithm.function = function;
+  algorithm.config = config;
+  algorithm.context = context;
+  return algorithm;
+}
+
+/**
+ * @brief Metric declaration with N algorithms; create with metric()
+ */
+template <std::size_t N> struct MetricSpec {
+  const char *name;
+  embedids_metric_type_t type;
+  uint32_t history_size;
+  bool enabled;
+  std::array<Algorithm, N> algorithms;
+  bool backpressured = false;
+
+  /** @brief Attach an algorithm */
+  constexpr MetricSpec<N + 1> with(const Algorithm &algorithm) const {
+    MetricSpec<N + 1> next{name, type, history_size, enabled, {}, backpressured};
+    for (std::size_t i = 0; i < N; ++i) {
+      next.algorithms[i] = algorithms[i];
+    }
+    next.algorithms[N] = algorithm;
+    return next;
+  }
+
+  /** @brief Declare the metric but leave it switched off */
+  constexpr MetricSpec disabled() const {
+    MetricSpec next = *this;
+    next.enabled = false;
+    return next;
+  }
+
+  /** @brief Refuse points instead of overwriting unacknowledged ones */
+  constexpr MetricSpec backpressure() const {
+    MetricSpec next = *this;
+    next.backpressured = true;
+    return next;
+  }
+};
+
+/** @brief Metric with a history of history_size points */
+constexpr MetricSpec<0> metric(const char *name, embedids_metric_type_t type,
+                           uint32_t history_size) {
+  return MetricSpec<0>{name, type, history_size, true, {}};
+}
+
+namespace detail {
+
+constexpr bool is_integer_type(embedids_metric_type_t type) {
+  return type == EMBEDIDS_METRIC_TYPE_UINT32 || type == EMBEDIDS_METRIC_TYPE_UINT64 ||
+         type == EMBEDIDS_METRIC_TYPE_ENUM;
+}
+
+constexpr bool is_float_type(embedids_metric_type_t type) {
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  if (type == EMBEDIDS_METRIC_TYPE_DOUBLE) {
+    return true;
+  }
+#endif
+  return type == EMBEDIDS_METRIC_TYPE_FLOAT || type == EMBEDIDS_METRIC_TYPE_PERCENTAGE ||
+         type == EMBEDIDS_METRIC_TYPE_RATE;
+#else
+  (void)type;
+  return false;
+#endif
+}
+
+constexpr bool type_supported(embedids_metric_type_t type) {
+  return is_integer_type(type) || is_float_type(type) ||
+         type == EMBEDIDS_METRIC_TYPE_BOOL;
+}
+
+constexpr unsigned long long integer_limit(embedids_metric_type_t type) {
+  return type == EMBEDIDS_METRIC_TYPE_UINT32 ? 0xffffffffull
+         : type == EMBEDIDS_METRIC_TYPE_ENUM ? 0xffull
+                                             : ~0ull;
+}
+
+constexpr bool bound_fits(const Bound &bound, embedids_metric_type_t type) {
+  if (bound.kind == BoundKind::None) {
+    return true;
+  }
+  if (is_integer_type(type)) {
+    return bound.kind == BoundKind::Integral && !bound.negative &&
+           bound.integral <= integer_limit(type);
+  }
+  if (is_float_type(type)) {
+    bool numeric = bound.kind == BoundKind::Floating || bound.kind == BoundKind::Integral;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+    if (type == EMBEDIDS_METRIC_TYPE_PERCENTAGE) {
+      return numeric && bound.floating >= 0.0 && bound.floating <= 100.0;
+    }
+#endif
+    return numeric;
+  }
+  return false; // the threshold algorithm does not compare bool metrics
+}
+
+constexpr bool bounds_ordered(const Algorithm &algorithm) {
+  const Bound &low = algorithm.min_bound;
+  const Bound &high = algorithm.max_bound;
+  if (low.kind == BoundKind::None || high.kind == BoundKind::None) {
+    return true;
+  }
+  // Magnitudes are exact for large unsigned bounds but carry no sign, so a
+  // negative bound (only valid on floating point metrics) compares as double
+  if (low.kind == BoundKind::Integral && high.kind == BoundKind::Integral &&
+      !low.negative && !high.negative) {
+    return low.integral <= high.integral;
+  }
+  return low.floating <= high.floating;
+}
+
+template <std::size_t N> constexpr bool thresholds_match(const MetricSpec<N> &metric) {
+  for (std::size_t i = 0; i < N; ++i) {
+    const Algorithm &algorithm = metric.algorithms[i];
+    if (algorithm.type == EMBEDIDS_ALGORITHM_THRESHOLD &&
+        (!bound_fits(algorithm.min_bound, metric.type) ||
+         !bound_fits(algorithm.max_bound, metric.type))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <std::size_t N> constexpr bool thresholds_valid(const MetricSpec<N> &metric) {
+  for (std::size_t i = 0; i < N; ++i) {
+    const Algorithm &algorithm = metric.algorithms[i];
+    if (algorithm.type == EMBEDIDS_ALGORITHM_THRESHOLD &&
+        ((algorithm.min_bound.kind == BoundKind::None &&
+          algorithm.max_bound.kind == BoundKind::None) ||
+         !bounds_ordered(algorithm))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <std::size_t N> constexpr bool trends_fit(const MetricSpec<N> &metric) {
+  for (std::size_t i = 0; i < N; ++i) {
+    const Algorithm &algorithm = metric.algorithms[i];
+    if (algorithm.type == EMBEDIDS_ALGORITHM_TREND &&
+        (algorithm.window_size < 2 || algorithm.window_size > metric.history_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <std::size_t N> constexpr bool customs_set(const MetricSpec<N> &metric) {
+  for (std::size_t i = 0; i < N; ++i) {
+    if (metric.algorithms[i].type == EMBEDIDS_ALGORITHM_CUSTOM &&
+        metric.algorithms[i].function == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <std::size_t Count>
+constexpr bool names_unique(const std::array<const char *, Count> &names) {
+  for (std::size_t i = 0; i < Count; ++i) {
+    for (std::size_t j = 0; j < i; ++j) {
+      if (equal(names[i], names[j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Per-metric compile-time checks, triggered by reading value
+ */
+template <const auto &M> struct MetricCheck {
+  static_assert(length(M.name) > 0, "metric name must not be empty");
+  static_assert(length(M.name) < EMBEDIDS_MAX_METRIC_NAME_LEN,
+                "metric name does not fit EMBEDIDS_MAX_METRIC_NAME_LEN");
+  static_assert(type_supported(M.type),
+                "metric type is not enabled in this build");
+  static_assert(M.history_size > 0, "metric needs a history of at least one point");
+  static_assert(M.algorithms.size() <= EMBEDIDS_MAX_ALGORITHMS_PER_METRIC,
+                "more algorithms than EMBEDIDS_MAX_ALGORITHMS_PER_METRIC");
+  static_assert(thresholds_match(M),
+                "threshold bound does not match the metric type");
+  static_assert(thresholds_valid(M),
+                "threshold needs a bound, and min must not exceed max");
+  static_assert(trends_fit(M),
+                "trend window must be at least 2 and fit the metric history");
+  static_assert(customs_set(M), "custom algorithm needs a function");
+  static constexpr bool value = true;
+};
+
+inline embedids_metric_value_t to_value(const Bound &bound, embedids_metric_type_t type) {
+  embedids_metric_value_t value;
+  std::memset(&value, 0, sizeof(value));
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    value.u32 = static_cast<uint32_t>(bound.integral);
+    break;
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    value.u64 = static_cast<uint64_t>(bound.integral);
+    break;
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    value.enum_val = static_cast<uint8_t>(bound.integral);
+    break;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    value.f32 = static_cast<float>(bound.floating);
+    break;
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    value.f64 = bound.floating;
+    break;
+#endif
+#endif
+  default:
+    break;
+  }
+  return value;
+}
+
+inline void emit_algorithm(const Algorithm &spec, embedids_metric_type_t type,
+                           embedids_algorithm_t &out) {
+  out.type = spec.type;
+  out.enabled = spec.enabled;
+  switch (spec.type) {
+  case EMBEDIDS_ALGORITHM_THRESHOLD:
+    out.config.threshold.check_min = spec.min_bound.kind != BoundKind::None;
+    out.config.threshold.check_max = spec.max_bound.kind != BoundKind::None;
+    out.config.threshold.min_threshold = to_value(spec.min_bound, type);
+    out.config.threshold.max_threshold = to_value(spec.max_bound, type);
+    break;
+  case EMBEDIDS_ALGORITHM_TREND:
+    out.config.trend.window_size = spec.window_size;
+    out.config.trend.max_slope = spec.max_slope;
+    out.config.trend.max_variance = spec.max_variance;
+    out.config.trend.expected_trend = spec.expected_trend;
+    break;
+  case EMBEDIDS_ALGORITHM_CUSTOM:
+    out.config.custom.function = spec.function;
+    out.config.custom.config = spec.config;
+    out.config.custom.context = spec.context;
+    break;
+  case EMBEDIDS_ALGORITHM_STREAM:
+    break; // Needs per-metric stream_instances, so not declarable here
+  }
+}
+
+template <std::size_t N>
+void emit_metric(const MetricSpec<N> &spec, embedids_metric_config_t &out,
+                 embedids_metric_datapoint_t *&history) {
+  std::memset(&out, 0, sizeof(out));
+  std::memcpy(out.metric.name, spec.name, length(spec.name));
+  out.metric.type = spec.type;
+  out.metric.history = history;
+  out.metric.max_history_size = spec.history_size;
+  out.metric.enabled = spec.enabled;
+  out.metric.backpressure = spec.backpressured;
+  history += spec.history_size;
+
+  out.num_algorithms = static_cast<uint32_t>(N);
+  for (std::size_t i = 0; i < N; ++i) {
+    emit_algorithm(spec.algorithms[i], spec.type, out.algorithms[i]);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Checked configuration with static storage for its metrics
+ *
+ * Every metric must be a constexpr object with static storage duration.
+ * All checks run at compile time; the C structures are filled in once, on
+ * the first call to system_config(), because C++17 cannot constant
+ * initialize the non-first members of embedids_algorithm_t's union.
+ * Storage is shared by every use of the same Config type.
+ */
+template <const auto &... Metrics> class Config {
+  static_assert(sizeof...(Metrics) > 0, "a configuration needs at least one metric");
+  static_assert(sizeof...(Metrics) <= EMBEDIDS_MAX_METRICS,
+                "more metrics than EMBEDIDS_MAX_METRICS");
+  static_assert((detail::MetricCheck<Metrics>::value && ...));
+  static_assert(detail::names_unique(std::array<const char *, sizeof...(Metrics)>{
+                    Metrics.name...}),
+                "metric names must be unique");
+
+public:
+  /** @brief Number of metrics */
+  static constexpr uint32_t num_metrics = sizeof...(Metrics);
+
+  /** @brief Data points of history across all metrics */
+  static constexpr uint32_t history_points = (0u + ... + Metrics.history_size);
+
+  /** @brief The system configuration, built on first use */
+  static embedids_system_config_t &system_config() {
+    static embedids_system_config_t *const config = materialize();
+    return *config;
+  }
+
+  /** @brief Initialize a context with this configuration */
+  static embedids_result_t init(embedids_context_t &context) {
+    return embedids_init(&context, &system_config());
+  }
+
+private:
+  inline static embedids_metric_config_t metrics_[num_metrics];
+  inline static embedids_metric_datapoint_t history_[history_points];
+  inline static embedids_system_config_t system_;
+
+  static embedids_system_config_t *materialize() {
+    embedids_metric_datapoint_t *history = history_;
+    std::size_t index = 0;
+    (detail::emit_metric(Metrics, metrics_[index++], history), ...);
+
+    system_.metrics = metrics_;
+    system_.max_metrics = num_metrics;
+    system_.num_active_metrics = num_metrics;
+    return &system_;
+  }
+};
+
+/**
+ * @brief Mapping from a C++ value type to its metric type and union member
+ *
+ * Specialized for every type the build supports; ENUM metrics use uint8_t
+ * and PERCENTAGE or RATE metrics use float with an explicit Type.
+ */
+template <typename T> struct MetricTraits;
+
+template <> struct MetricTraits<uint32_t> {
+  static constexpr embedids_metric_type_t type = EMBEDIDS_METRIC_TYPE_UINT32;
+  static uint32_t get(const embedids_metric_value_t &value) { return value.u32; }
+  static embedids_metric_value_t make(uint32_t v) {
+    embedids_metric_value_t value;
+    std::memset(&value, 0, sizeof(value));
+    value.u32 = v;
+    return value;
+  }
+};
+
+template <> struct MetricTraits<uint64_t> {
+  static constexpr embedids_metric_type_t type = EMBEDIDS_METRIC_TYPE_UINT64;
+  static uint64_t get(const embedids_metric_value_t &value) { return value.u64; }
+  static embedids_metric_value_t make(uint64_t v) {
+    embedids_metric_value_t value;
+    std::memset(&value, 0, sizeof(value));
+    value.u64 = v;
+    return value;
+  }
+};
+
+template <> struct MetricTraits<uint8_t> {
+  static constexpr embedids_metric_type_t type = EMBEDIDS_METRIC_TYPE_ENUM;
+  static uint8_t get(const embedids_metric_value_t &value) { return value.enum_val; }
+  static embedids_metric_value_t make(uint8_t v) {
+    embedids_metric_value_t value;
+    std::memset(&value, 0, sizeof(value));
+    value.enum_val = v;
+    return value;
+  }
+};
+
+template <> struct MetricTraits<bool> {
+  static constexpr embedids_metric_type_t type = EMBEDIDS_METRIC_TYPE_BOOL;
+  static bool get(const embedids_metric_value_t &value) { return value.boolean; }
+  static embedids_metric_value_t make(bool v) {
+    embedids_metric_value_t value;
+    std::memset(&value, 0, sizeof(value));
+    value.boolean = v;
+    return value;
+  }
+};
+
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+template <> struct MetricTraits<float> {
+  static constexpr embedids_metric_type_t type = EMBEDIDS_METRIC_TYPE_FLOAT;
+  static float get(const embedids_metric_value_t &value) { return value.f32; }
+  static embedids_metric_value_t make(float v) {
+    embedids_metric_value_t value;
+    std::memset(&value, 0, sizeof(value));
+    value.f32 = v;
+    return value;
+  }
+};
+
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+template <> struct MetricTraits<double> {
+  static constexpr embedids_metric_type_t type = EMBEDIDS_METRIC_TYPE_DOUBLE;
+  static double get(const embedids_metric_value_t &value) { return value.f64; }
+  static embedids_metric_value_t make(double v) {
+    embedids_metric_value_t value;
+    std::memset(&value, 0, sizeof(value));
+    value.f64 = v;
+    return value;
+  }
+};
+#endif
+#endif
+
+/**
+ * @brief Typed threshold kernel; same semantics as EMBEDIDS_ALGORITHM_THRESHOLD
+ */
+template <typename T> struct Threshold {
+  static_assert(!std::is_same_v<T, bool>,
+                "the threshold algorithm does not compare bool metrics");
+
+  T min_value{};
+  T max_value{};
+  bool check_min = false;
+  bool check_max = false;
+
+  /** @brief Set the lower bound */
+  constexpr Threshold min(T value) const {
+    Threshold next = *this;
+    next.min_value = value;
+    next.check_min = true;
+    return next;
+  }
+
+  /** @brief Set the upper bound */
+  constexpr Threshold max(T value) const {
+    Threshold next = *this;
+    next.max_value = value;
+    next.check_max = true;
+    return next;
+  }
+
+  /** @brief Check the newest value of a metric */
+  template <typename M> embedids_result_t operator()(const M &metric) const {
+    if (metric.empty()) {
+      return EMBEDIDS_OK;
+    }
+    const T latest = metric.latest();
+    if ((check_min && latest < min_value) || (check_max && latest > max_value)) {
+      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
+    }
+    return EMBEDIDS_OK;
+  }
+};
+
+/**
+ * @brief Typed summary, the counterpart of embedids_metric_summary_t
+ */
+template <typename T> struct Summary {
+  uint32_t count = 0;
+  T min{};
+  T max{};
+  T last{};
+  float mean = 0.0f;
+  uint64_t first_timestamp_ms = 0;
+  uint64_t last_timestamp_ms = 0;
+};
+
+/**
+ * @brief Metric with a typed, fixed-capacity history ring
+ *
+ * Values are stored as T, so the kernels below are instantiated per type
+ * and compile without the runtime type switches of the C API. Type selects
+ * the C metric type used by export_to(); it must share T's union member.
+ *
+ * @code
+ * embedids::Metric<float, 32, EMBEDIDS_METRIC_TYPE_PERCENTAGE> cpu;
+ * cpu.push(42.0f, now_ms);
+ * result = cpu.analyze(embedids::Threshold<float>{}.max(90.0f));
+ * @endcode
+ */
+template <typename T, std::size_t Capacity,
+          embedids_metric_type_t Type = MetricTraits<T>::type>
+class Metric {
+  static_assert(Capacity > 0, "metric needs a history of at least one point");
+  static_assert(Capacity <= UINT32_MAX, "metric history must fit uint32_t indices");
+
+public:
+  using value_type = T;
+
+  /** @brief C metric type written by export_to() */
+  static constexpr embedids_metric_type_t type = Type;
+
+  /** @brief Maximum number of stored points */
+  static constexpr uint32_t capacity = static_cast<uint32_t>(Capacity);
+
+  /** @brief Append a point, overwriting the oldest once full */
+  void push(T value, uint64_t timestamp_ms) {
+    values_[write_index_] = value;
+    timestamps_[write_index_] = timestamp_ms;
+    write_index_ = (write_index_ + 1 == capacity) ? 0 : write_index_ + 1;
+    if (size_ < capacity) {
+      size_++;
+    }
+  }
+
+  /** @brief Drop all points */
+  void clear() {
+    write_index_ = 0;
+    size_ = 0;
+  }
+
+  uint32_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /** @brief Point i, counted from the oldest stored point */
+  T at(uint32_t i) const { return values_[physical(i)]; }
+
+  /** @brief Timestamp of point i, counted from the oldest stored point */
+  uint64_t timestamp_at(uint32_t i) const { return timestamps_[physical(i)]; }
+
+  /** @brief Newest point; the metric must not be empty */
+  T latest() const { return values_[write_index_ == 0 ? capacity - 1 : write_index_ - 1]; }
+
+  /** @brief Run kernels in order and return the first failure */
+  template <typename... Kernels> embedids_result_t analyze(const Kernels &...kernels) const {
+    embedids_result_t result = EMBEDIDS_OK;
+    (void)(((result = kernels(*this)) == EMBEDIDS_OK) && ...);
+    return result;
+  }
+
+  /** @brief Same classification as embedids_get_trend() */
+  embedids_trend_t trend() const {
+    if constexpr (!std::is_same_v<T, uint32_t> && !std::is_same_v<T, uint64_t> &&
+                  !std::is_same_v<T, float>) {
+      return EMBEDIDS_TREND_STABLE; // no trend for bool, enum or double metrics
+    }
+    if (size_ < 2) {
+      return EMBEDIDS_TREND_STABLE;
+    }
+    uint32_t points = size_ < 3 ? size_ : 3;
+    float sum_change = 0.0f;
+    for (uint32_t i = 1; i < points; ++i) {
+      sum_change += static_cast<float>(at(i)) - static_cast<float>(at(i - 1));
+    }
+    float avg_change = sum_change / static_cast<float>(points - 1);
+
+    float first = static_cast<float>(at(0));
+    float threshold = (first < 0.0f ? -first : first) * 0.05f;
+    if (threshold < 1.0f) {
+      threshold = 1.0f;
+    }
+    if ((avg_change < 0.0f ? -avg_change : avg_change) < threshold) {
+      return EMBEDIDS_TREND_STABLE;
+    }
+    return avg_change > 0.0f ? EMBEDIDS_TREND_INCREASING : EMBEDIDS_TREND_DECREASING;
+  }
+
+  /** @brief Min, max, mean and last value over the stored points */
+  Summary<T> summary() const {
+    Summary<T> summary;
+    if (size_ == 0) {
+      return summary;
+    }
+    summary.min = summary.max = at(0);
+    summary.first_timestamp_ms = timestamp_at(0);
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < size_; ++i) {
+      T value = at(i);
+      summary.min = value < summary.min ? value : summary.min;
+      summary.max = summary.max < value ? value : summary.max;
+      sum += static_cast<float>(value);
+    }
+    summary.count = size_;
+    summary.last = latest();
+    summary.last_timestamp_ms = timestamp_at(size_ - 1);
+    summary.mean = sum / static_cast<float>(size_);
+    return summary;
+  }
+
+  /**
+   * @brief Copy the ring into a C metric so the C API can analyze it
+   *
+   * The target is a metric of context; it keeps its name, algorithms and
+   * history buffer, its type must equal Type and its history must hold at
+   * least size() points. The copy is handed over with
+   * embedids_adopt_history(), so checksums, range index, stream algorithms
+   * and alerts follow the new points.
+   */
+  embedids_result_t export_to(embedids_context_t &context, embedids_metric_t &metric) const {
+    if (metric.type != Type) {
+      return EMBEDIDS_ERROR_INVALID_PARAM;
+    }
+    if (metric.history == nullptr || metric.max_history_size < size_) {
+      return EMBEDIDS_ERROR_BUFFER_FULL;
+    }
+    if (!context.initialized) {
+      return EMBEDIDS_ERROR_NOT_INITIALIZED;
+    }
+
+    // Only write into a history the context will then adopt
+    const embedids_system_config_t &system = *context.system_config;
+    bool owned = false;
+    for (uint32_t i = 0; i < system.num_active_metrics && !owned; ++i) {
+      owned = &system.metrics[i].metric == &metric;
+    }
+    if (!owned) {
+      return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+    }
+
+    for (uint32_t i = 0; i < size_; ++i) {
+      metric.history[i].value = MetricTraits<T>::make(at(i));
+      metric.history[i].timestamp_ms = timestamp_at(i);
+      metric.history[i].flags = 0;
+    }
+    return embedids_adopt_history(&context, metric.name, size_);
+  }
+
+private:
+  static_assert(MetricTraits<T>::type == Type ||
+                    (std::is_same_v<T, float> && detail::is_float_type(Type)),
+                "metric type does not store values as T");
+
+  std::array<T, Capacity> values_{};
+  std::array<uint64_t, Capacity> timestamps_{};
+  uint32_t write_index_ = 0;
+  uint32_t size_ = 0;
+
+  uint32_t physical(uint32_t i) const {
+    uint32_t index = (size_ == capacity ? write_index_ : 0) + i;
+    return index >= capacity ? index - capacity : index;
+  }
+};
+
+} // namespace embedids
+
+#endif /* EMBEDIDS_HPP */
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EMBEDIDS_CORO_HPP
+#define EMBEDIDS_CORO_HPP
+
+/**
+ * @brief Coroutine analysis for C++20 consumers
+ *
+ * analyze_async() runs a pass in slices of a few metrics and suspends on a
+ * caller-supplied awaitable between slices, so the pass can share an event
+ * loop thread with other work. Anomalies come out as a stream:
+ *
+ * @code
+ * auto stream = embedids::analyze_async(context, [&] { return loop.schedule(); });
+ * while (auto anomaly = co_await stream.next()) {
+ *   report(anomaly->name, anomaly->result);
+ * }
+ * @endcode
+ *
+ * The header is empty before C++20 so it can be included unconditionally.
+ */
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include "embedids.h"
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace embedids {
+
+/**
+ * @brief Metric whose algorithms reported an anomaly
+ */
+struct Anomaly {
+  uint32_t slot;            /**< Slot in the system configuration */
+  const char *name;         /**< Metric name, nullptr if the context is unusable */
+  embedids_result_t result; /**< First failing algorithm result */
+};
+
+/**
+ * @brief Asynchronous stream of anomalies from one analysis pass
+ *
+ * The pass starts on the first next() and runs on whichever thread resumes
+ * it. Drain the stream before destroying it; a pass suspended between
+ * slices must not be destroyed while the executor still holds it.
+ */
+class AnomalyStream {
+public:
+  struct promise_type {
+    std::optional<Anomaly> current;
+    std::coroutine_handle<> consumer = std::noop_coroutine();
+
+    /** @brief Hands control back to the coroutine waiting in next() */
+    struct ToConsumer {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<promise_type> producer) noexcept {
+        return producer.promise().consumer;
+      }
+      void await_resume() noexcept {}
+    };
+
+    AnomalyStream get_return_object() {
+      return AnomalyStream{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    ToConsumer final_suspend() noexcept { return {}; }
+    ToConsumer yield_value(const Anomaly &anomaly) noexcept {
+      current = anomaly;
+      return {};
+    }
+    void return_void() noexcept { current.reset(); }
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  /** @brief Awaitable returned by next() */
+  struct NextAwaiter {
+    std::coroutine_handle<promise_type> producer;
+
+    bool await_ready() const noexcept { return !producer || producer.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+      producer.promise().consumer = consumer;
+      return producer;
+    }
+    std::optional<Anomaly> await_resume() const noexcept {
+      if (!producer || producer.done()) {
+        return std::nullopt;
+      }
+      return producer.promise().current;
+    }
+  };
+
+  AnomalyStream(AnomalyStream &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  AnomalyStream &operator=(AnomalyStream &&other) noexcept {
+    if (this != &other) {
+      reset();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  AnomalyStream(const AnomalyStream &) = delete;
+  AnomalyStream &operator=(const AnomalyStream &) = delete;
+  ~AnomalyStream() { reset(); }
+
+  /** @brief Resume the pass until the next anomaly; nullopt once it is done */
+  NextAwaiter next() const noexcept { return NextAwaiter{handle_}; }
+
+  /** @brief True once the pass has visited every metric */
+  bool done() const noexcept { return !handle_ || handle_.done(); }
+
+private:
+  explicit AnomalyStream(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  void reset() noexcept {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Analyze every enabled metric, suspending between slices
+ *
+ * @param context Initialized context; must outlive the stream
+ * @param reschedule Callable returning an awaitable that resumes the pass
+ *                   later, typically by posting it to the event loop
+ * @param budget Metrics analyzed per slice; 0 is treated as 1
+ * @return Stream of the anomalies found, in slot order
+ */
+template <typename Reschedule>
+AnomalyStream analyze_async(embedids_context_t &context, Reschedule reschedule,
+                            uint32_t budget = 1) {
+  uint32_t slice = budget == 0 ? 1 : budget;
+  uint32_t cursor = 0;
+  for (;;) {
+    for (uint32_t step = 0; step < slice; ++step) {
+      uint32_t slot = 0;
+      embedids_result_t result = embedids_analyze_next(&context, &cursor, &slot);
+      if (result == EMBEDIDS_ERROR_METRIC_NOT_FOUND) {
+        co_return;
+      }
+      if (result == EMBEDIDS_ERROR_NOT_INITIALIZED) {
+        co_yield Anomaly{cursor, nullptr, result};
+        co_return;
+      }
+      if (result != EMBEDIDS_OK) {
+        co_yield Anomaly{slot, context.system_config->metrics[slot].metric.name, result};
+      }
+    }
+    co_await reschedule();
+  }
+}
+
+} // namespace embedids
+
+#endif /* __cplusplus >= 202002L */
+
+#endif /* EMBEDIDS_CORO_HPP */
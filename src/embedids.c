@@ -15,33 +15,118 @@
  */
 
 #include "embedids.h"
+#include "embedids_internal.h"
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
+/* FNV-1a over the name, reduced to a name index position */
+static uint32_t name_hash(const char *name) {
+  uint32_t hash = 2166136261u;
+  for (uint32_t i = 0; i < EMBEDIDS_MAX_METRIC_NAME_LEN && name[i] != '\0'; i++) {
+    hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+  }
+  return hash % EMBEDIDS_NAME_INDEX_SIZE;
+}
+
+/*
+ * Position of name in the index, or of the empty entry ending its probe
+ * chain. The index holds at most half as many names as entries, so an
+ * empty entry always exists.
+ */
+static uint32_t name_index_probe(const embedids_context_t *context,
+                                 const char *name, bool *found) {
+  uint32_t pos = name_hash(name);
+  while (context->name_index[pos] != 0) {
+    const embedids_metric_t *metric =
+        &context->system_config->metrics[context->name_index[pos] - 1].metric;
+    if (strncmp(metric->name, name, EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
+      *found = true;
+      return pos;
+    }
+    pos = (pos + 1) % EMBEDIDS_NAME_INDEX_SIZE;
+  }
+  *found = false;
+  return pos;
+}
+
+/* Delete an index entry, shifting later chain members back over the hole */
+static void name_index_remove(embedids_context_t *context, uint32_t pos) {
+  uint32_t hole = pos;
+  uint32_t next = (pos + 1) % EMBEDIDS_NAME_INDEX_SIZE;
+  while (context->name_index[next] != 0) {
+    const embedids_metric_t *metric =
+        &context->system_config->metrics[context->name_index[next] - 1].metric;
+    uint32_t home = name_hash(metric->name);
+
+    // Move the entry only if its home does not lie between hole and next
+    uint32_t from_home = (next + EMBEDIDS_NAME_INDEX_SIZE - home) % EMBEDIDS_NAME_INDEX_SIZE;
+    uint32_t from_hole = (next + EMBEDIDS_NAME_INDEX_SIZE - hole) % EMBEDIDS_NAME_INDEX_SIZE;
+    if (from_home >= from_hole) {
+      context->name_index[hole] = context->name_index[next];
+      hole = next;
+    }
+    next = (next + 1) % EMBEDIDS_NAME_INDEX_SIZE;
+  }
+  context->name_index[hole] = 0;
+}
+
+/* First position in sorted_slots whose name does not sort before key */
+static uint32_t sorted_lower_bound(const embedids_context_t *context,
+                                   const char *key) {
+  uint32_t low = 0;
+  uint32_t high = context->num_sorted_slots;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    const char *name =
+        context->system_config->metrics[context->sorted_slots[mid]].metric.name;
+    if (strncmp(name, key, EMBEDIDS_MAX_METRIC_NAME_LEN) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+static void sorted_insert(embedids_context_t *context, uint32_t slot) {
+  uint32_t pos =
+      sorted_lower_bound(context, context->system_config->metrics[slot].metric.name);
+  memmove(&context->sorted_slots[pos + 1], &context->sorted_slots[pos],
+          context->num_sorted_slots - pos);
+  context->sorted_slots[pos] = (uint8_t)slot;
+  context->num_sorted_slots++;
+}
+
+/* Must run while the slot still has its name; indexed names are unique */
+static void sorted_remove(embedids_context_t *context, uint32_t slot) {
+  uint32_t pos =
+      sorted_lower_bound(context, context->system_config->metrics[slot].metric.name);
+  memmove(&context->sorted_slots[pos], &context->sorted_slots[pos + 1],
+          context->num_sorted_slots - pos - 1);
+  context->num_sorted_slots--;
+}
+
 /* Helper function to find a metric by name */
-static embedids_metric_config_t *find_metric_config(const embedids_context_t *context, const char *metric_name) {
+embedids_metric_config_t *embedids_find_metric_config(const embedids_context_t *context, const char *metric_name) {
   if (!context || !context->system_config) {
     return NULL;
   }
 
-  for (uint32_t i = 0; i < context->system_config->num_active_metrics;
-       i++) {
-    embedids_metric_config_t *config =
-        &context->system_config->metrics[i];
-    if (strncmp(config->metric.name, metric_name,
-                EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
-      return config;
-    }
+  bool found = false;
+  uint32_t pos = name_index_probe(context, metric_name, &found);
+  if (!found) {
+    return NULL;
   }
-  return NULL;
+  return &context->system_config->metrics[context->name_index[pos] - 1];
 }
 
-/* Built-in threshold algorithm implementation */
+/* Built-in threshold algorithm implementation; score is set on detection */
 static embedids_result_t
 run_threshold_algorithm(const embedids_metric_t *metric,
-                        const embedids_threshold_config_t *config) {
+                        const embedids_threshold_config_t *config, float *score) {
   if (metric->current_size == 0) {
     return EMBEDIDS_OK; // No data to analyze
   }
@@ -53,42 +138,28 @@ run_threshold_algorithm(const embedids_metric_t *metric,
   embedids_metric_value_t latest_value = metric->history[latest_index].value;
 
   // Check thresholds based on metric type
+  bool below = false;
+  bool above = false;
   switch (metric->type) {
   case EMBEDIDS_METRIC_TYPE_UINT32:
-    if (config->check_min && latest_value.u32 < config->min_threshold.u32) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
-    if (config->check_max && latest_value.u32 > config->max_threshold.u32) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
+    below = config->check_min && latest_value.u32 < config->min_threshold.u32;
+    above = config->check_max && latest_value.u32 > config->max_threshold.u32;
     break;
   case EMBEDIDS_METRIC_TYPE_UINT64:
-    if (config->check_min && latest_value.u64 < config->min_threshold.u64) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
-    if (config->check_max && latest_value.u64 > config->max_threshold.u64) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
+    below = config->check_min && latest_value.u64 < config->min_threshold.u64;
+    above = config->check_max && latest_value.u64 > config->max_threshold.u64;
     break;
 #if EMBEDIDS_ENABLE_FLOATING_POINT
   case EMBEDIDS_METRIC_TYPE_FLOAT:
   case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
   case EMBEDIDS_METRIC_TYPE_RATE:
-    if (config->check_min && latest_value.f32 < config->min_threshold.f32) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
-    if (config->check_max && latest_value.f32 > config->max_threshold.f32) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
+    below = config->check_min && latest_value.f32 < config->min_threshold.f32;
+    above = config->check_max && latest_value.f32 > config->max_threshold.f32;
     break;
 #if EMBEDIDS_ENABLE_DOUBLE_PRECISION
   case EMBEDIDS_METRIC_TYPE_DOUBLE:
-    if (config->check_min && latest_value.f64 < config->min_threshold.f64) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
-    if (config->check_max && latest_value.f64 > config->max_threshold.f64) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
-    }
+    below = config->check_min && latest_value.f64 < config->min_threshold.f64;
+    above = config->check_max && latest_value.f64 > config->max_threshold.f64;
     break;
 #endif
 #endif
@@ -97,150 +168,1213 @@ run_threshold_algorithm(const embedids_metric_t *metric,
     break;
   case EMBEDIDS_METRIC_TYPE_ENUM:
     // Enum metrics could use discrete value checking
-    if (config->check_min &&
-        latest_value.enum_val < config->min_threshold.enum_val) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
+    below = config->check_min && latest_value.enum_val < config->min_threshold.enum_val;
+    above = config->check_max && latest_value.enum_val > config->max_threshold.enum_val;
+    break;
+  }
+
+  if (!below && !above) {
+    return EMBEDIDS_OK;
+  }
+
+  // Excess relative to the bound it crossed; a zero bound counts as 1
+  float value = embedids_value_as_float(metric->type, latest_value);
+  float bound = embedids_value_as_float(
+      metric->type, below ? config->min_threshold : config->max_threshold);
+  float scale = bound < 0.0f ? -bound : bound;
+  *score = (below ? bound - value : value - bound) / (scale > 0.0f ? scale : 1.0f);
+  return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
+}
+
+/* Built-in trend algorithm implementation */
+static embedids_result_t
+run_trend_algorithm(const embedids_metric_t *metric,
+                    const embedids_trend_config_t *config) {
+  if (metric->current_size < config->window_size || config->window_size < 2) {
+    return EMBEDIDS_OK; // Not enough data for trend analysis
+  }
+
+  // TODO: Implement full trend analysis using linear regression
+  // This is a placeholder that needs proper implementation
+  (void)metric;  // Suppress unused parameter warning
+  (void)config;  // Suppress unused parameter warning
+  
+  return EMBEDIDS_OK;
+}
+
+/* Verify a metric's history, then run its algorithms; detection may be NULL */
+static embedids_result_t analyze_config(embedids_metric_config_t *config,
+                                        embedids_detection_t *detection) {
+  embedids_result_t result = embedids_integrity_verify(&config->metric);
+  if (result != EMBEDIDS_OK) {
+    if (detection) {
+      // Tampered history outranks any value anomaly
+      embedids_detection_clear(detection);
+      detection->result = result;
+      detection->severity = EMBEDIDS_SEVERITY_CRITICAL;
+      detection->score = FLT_MAX;
+    }
+    return result;
+  }
+  return embedids_run_algorithms(config, detection);
+}
+
+embedids_result_t embedids_init(embedids_context_t *context, const embedids_system_config_t *config) {
+  if (context == NULL || config == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint32_t num_slots = config->metrics ? config->num_active_metrics : 0;
+  if (num_slots > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  context->system_config = (embedids_system_config_t *)config;
+  context->datapoint_hook = NULL;
+  context->datapoint_hook_context = NULL;
+  context->slots_pinned = false;
+  context->epoch = 0;
+
+  // Index named slots; unnamed ones are free, lowest handed out first
+  memset(context->name_index, 0, sizeof(context->name_index));
+  context->num_free_slots = 0;
+  for (uint32_t i = num_slots; i-- > 0;) {
+    const embedids_metric_t *metric = &config->metrics[i].metric;
+    if (metric->name[0] == '\0') {
+      context->free_slots[context->num_free_slots++] = (uint8_t)i;
+      continue;
+    }
+
+    // Walking downwards, a duplicate name ends up on its lowest slot,
+    // matching what a linear search would find
+    bool found = false;
+    uint32_t pos = name_index_probe(context, metric->name, &found);
+    context->name_index[pos] = (uint16_t)(i + 1);
+  }
+
+  // Order the indexed slots by name for namespace queries
+  context->num_sorted_slots = 0;
+  for (uint32_t i = 0; i < num_slots; i++) {
+    const char *name = config->metrics[i].metric.name;
+    bool found = false;
+    if (name[0] != '\0' &&
+        context->name_index[name_index_probe(context, name, &found)] == i + 1) {
+      sorted_insert(context, i);
+    }
+  }
+
+  // Checksums, range indexes and stream algorithms start from whatever the
+  // rings already hold; alerts start clear
+  for (uint32_t i = 0; i < num_slots; i++) {
+    embedids_metric_config_t *slot = &context->system_config->metrics[i];
+    embedids_integrity_seal(&slot->metric);
+    embedids_range_build(&slot->metric);
+    if (slot->metric.name[0] != '\0') {
+      embedids_stream_restart(slot, false);
+      embedids_alert_clear(slot);
+    }
+  }
+
+  context->initialized = true;
+  return EMBEDIDS_OK;
+}
+
+/* Check a metric's voting policy; NULL means none */
+static embedids_result_t validate_ensemble(const embedids_ensemble_t *ensemble,
+                                           uint32_t num_algorithms) {
+  if (ensemble == NULL) {
+    return EMBEDIDS_OK;
+  }
+
+  switch (ensemble->policy) {
+  case EMBEDIDS_ENSEMBLE_ANY:
+  case EMBEDIDS_ENSEMBLE_ALL:
+    return EMBEDIDS_OK;
+  case EMBEDIDS_ENSEMBLE_K_OF_N:
+    // A vote that can never pass would silence the metric
+    return ensemble->k > 0 && ensemble->k <= num_algorithms ? EMBEDIDS_OK
+                                                            : EMBEDIDS_ERROR_CONFIG_INVALID;
+  case EMBEDIDS_ENSEMBLE_WEIGHTED:
+    if (!(ensemble->threshold > 0.0f) || !isfinite(ensemble->threshold)) {
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+    // Negative or non-finite weights would let one algorithm veto or
+    // saturate the sum
+    for (uint32_t a = 0; ensemble->weights && a < num_algorithms; a++) {
+      if (!(ensemble->weights[a] >= 0.0f) || !isfinite(ensemble->weights[a])) {
+        return EMBEDIDS_ERROR_CONFIG_INVALID;
+      }
+    }
+    return EMBEDIDS_OK;
+  }
+  return EMBEDIDS_ERROR_CONFIG_INVALID;
+}
+
+/* Check a metric's own algorithms or, if it references one, its shared set */
+static embedids_result_t validate_algorithms(const embedids_metric_config_t *config) {
+  if (config->num_algorithms > EMBEDIDS_MAX_ALGORITHMS_PER_METRIC) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  // A metric runs either its own algorithms or a shared set, never both
+  if (config->algorithm_set != NULL &&
+      (config->num_algorithms != 0 ||
+       (config->algorithm_set->num_algorithms != 0 && config->algorithm_set->algorithms == NULL))) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  uint32_t count = 0;
+  const embedids_algorithm_t *algorithms = embedids_metric_algorithms(config, &count);
+  embedids_result_t result = validate_ensemble(config->ensemble, count);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  for (uint32_t a = 0; a < count; a++) {
+    const embedids_algorithm_t *algorithm = &algorithms[a];
+    switch (algorithm->type) {
+    case EMBEDIDS_ALGORITHM_THRESHOLD:
+    case EMBEDIDS_ALGORITHM_TREND:
+      break;
+    case EMBEDIDS_ALGORITHM_CUSTOM:
+      if (algorithm->enabled && algorithm->config.custom.function == NULL) {
+        return EMBEDIDS_ERROR_CUSTOM_ALGORITHM_NULL;
+      }
+      break;
+    case EMBEDIDS_ALGORITHM_STREAM:
+      if (algorithm->enabled && algorithm->config.stream.function == NULL) {
+        return EMBEDIDS_ERROR_CUSTOM_ALGORITHM_NULL;
+      }
+      if (config->stream_instances == NULL) {
+        return EMBEDIDS_ERROR_CONFIG_INVALID;
+      }
+      break;
+    default:
+      return EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED;
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_register_metric(embedids_context_t *context,
+                                           const embedids_metric_config_t *config,
+                                           uint32_t *slot) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (context->slots_pinned) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  if (config == NULL || config->metric.name[0] == '\0' ||
+      config->metric.history == NULL || config->metric.max_history_size == 0) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (memchr(config->metric.name, '\0', EMBEDIDS_MAX_METRIC_NAME_LEN) == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NAME_TOO_LONG;
+  }
+
+  embedids_result_t result = validate_algorithms(config);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  bool found = false;
+  uint32_t pos = name_index_probe(context, config->metric.name, &found);
+  if (found) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  embedids_system_config_t *system = context->system_config;
+  uint32_t index;
+  if (context->num_free_slots > 0) {
+    index = context->free_slots[--context->num_free_slots];
+  } else if (system->metrics != NULL && system->num_active_metrics < system->max_metrics &&
+             system->num_active_metrics < EMBEDIDS_MAX_METRICS) {
+    index = system->num_active_metrics++;
+  } else {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  embedids_metric_config_t *target = &system->metrics[index];
+  *target = *config;
+  target->metric.current_size = 0;
+  target->metric.write_index = 0;
+  target->metric.unacked = 0;
+  context->name_index[pos] = (uint16_t)(index + 1);
+  sorted_insert(context, index);
+  embedids_stream_restart(target, false);
+  embedids_alert_clear(target);
+
+  if (slot != NULL) {
+    *slot = index;
+  }
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_unregister_metric(embedids_context_t *context,
+                                             const char *metric_name) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (context->slots_pinned) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  bool found = false;
+  uint32_t pos = name_index_probe(context, metric_name, &found);
+  if (!found) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  // Unindex before clearing: the shift rehashes the remaining names only
+  uint32_t index = context->name_index[pos] - 1u;
+  name_index_remove(context, pos);
+  sorted_remove(context, index);
+  memset(&context->system_config->metrics[index], 0, sizeof(embedids_metric_config_t));
+  context->free_slots[context->num_free_slots++] = (uint8_t)index;
+
+  return EMBEDIDS_OK;
+}
+
+/* Metrics in a namespace: the exact name plus a run of sorted_slots */
+typedef struct {
+  int32_t exact;  /* slot named exactly like the prefix, -1 if none */
+  uint32_t begin; /* sorted_slots range of the metrics below the prefix */
+  uint32_t end;
+} prefix_match_t;
+
+static embedids_result_t match_prefix(const embedids_context_t *context,
+                                      const char *prefix, prefix_match_t *match) {
+  match->exact = -1;
+  match->begin = 0;
+  match->end = 0;
+
+  const char *terminator = memchr(prefix, '\0', EMBEDIDS_MAX_METRIC_NAME_LEN);
+  if (terminator == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND; // longer than any metric name
+  }
+  size_t len = (size_t)(terminator - prefix);
+  if (len > 0 && prefix[len - 1] == '.') {
+    len--;
+  }
+  if (len == 0) {
+    match->end = context->num_sorted_slots;
+    return match->end > 0 ? EMBEDIDS_OK : EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  // Children are exactly the names starting with "prefix."
+  char key[EMBEDIDS_MAX_METRIC_NAME_LEN + 1];
+  memcpy(key, prefix, len);
+  key[len] = '\0';
+
+  bool found = false;
+  uint32_t pos = name_index_probe(context, key, &found);
+  if (found) {
+    match->exact = (int32_t)context->name_index[pos] - 1;
+  }
+
+  key[len] = '.';
+  key[len + 1] = '\0';
+  match->begin = sorted_lower_bound(context, key);
+  match->end = match->begin;
+  while (match->end < context->num_sorted_slots &&
+         strncmp(context->system_config->metrics[context->sorted_slots[match->end]]
+                     .metric.name,
+                 key, len + 1) == 0) {
+    match->end++;
+  }
+
+  return (found || match->end > match->begin) ? EMBEDIDS_OK
+                                              : EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+}
+
+static uint32_t prefix_match_count(const prefix_match_t *match) {
+  return (match->exact >= 0 ? 1u : 0u) + match->end - match->begin;
+}
+
+static embedids_metric_config_t *prefix_match_config(const embedids_context_t *context,
+                                                     const prefix_match_t *match,
+                                                     uint32_t i) {
+  if (match->exact >= 0) {
+    if (i == 0) {
+      return &context->system_config->metrics[match->exact];
+    }
+    i--;
+  }
+  return &context->system_config->metrics[context->sorted_slots[match->begin + i]];
+}
+
+embedids_result_t embedids_analyze_prefix(embedids_context_t *context,
+                                          const char *prefix) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (prefix == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  prefix_match_t match;
+  embedids_result_t result = match_prefix(context, prefix, &match);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  for (uint32_t i = 0; i < prefix_match_count(&match); i++) {
+    embedids_metric_config_t *config = prefix_match_config(context, &match, i);
+    if (config->metric.enabled) {
+      result = analyze_config(config, NULL);
+      if (result != EMBEDIDS_OK) {
+        return result; // Return first anomaly detected
+      }
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_set_enabled_prefix(embedids_context_t *context,
+                                              const char *prefix, bool enabled,
+                                              uint32_t *count) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (prefix == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  prefix_match_t match;
+  embedids_result_t result = match_prefix(context, prefix, &match);
+  if (count != NULL) {
+    *count = prefix_match_count(&match);
+  }
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  for (uint32_t i = 0; i < prefix_match_count(&match); i++) {
+    prefix_match_config(context, &match, i)->metric.enabled = enabled;
+  }
+
+  return EMBEDIDS_OK;
+}
+
+/* Check that a metric takes a new point */
+static inline embedids_result_t admit_datapoint(const embedids_metric_t *metric) {
+  if (!metric->enabled) {
+    return EMBEDIDS_ERROR_METRIC_DISABLED;
+  }
+  if (metric->backpressure && metric->unacked == metric->max_history_size) {
+    return EMBEDIDS_ERROR_BUFFER_FULL;
+  }
+  return EMBEDIDS_OK;
+}
+
+/* Slot for the next point; its old contents leave the checksummed history */
+static inline embedids_metric_datapoint_t *claim_datapoint(embedids_metric_t *metric) {
+  if (metric->block_crcs) {
+    embedids_integrity_retire(metric, metric->write_index);
+  }
+  return &metric->history[metric->write_index];
+}
+
+/* Advance the ring past a point just written at write_index. write_index is
+ * stored before current_size: persistent reattach completes a commit cut
+ * off between the two. */
+static inline void commit_datapoint(embedids_context_t *context,
+                                    embedids_metric_config_t *config,
+                                    const embedids_metric_datapoint_t *datapoint) {
+  embedids_metric_t *metric = &config->metric;
+  if (metric->block_crcs) {
+    embedids_integrity_update(metric, metric->write_index);
+  }
+  if (metric->range_index) {
+    embedids_range_update(metric, metric->write_index);
+  }
+  metric->write_index =
+      (metric->write_index + 1 == metric->max_history_size) ? 0 : metric->write_index + 1;
+  if (metric->current_size < metric->max_history_size) {
+    metric->current_size++;
+  }
+  metric->unacked += metric->backpressure;
+  metric->sequence++;
+
+  if (context->datapoint_hook) {
+    context->datapoint_hook(
+        (uint32_t)(config - context->system_config->metrics), datapoint,
+        context->datapoint_hook_context);
+  }
+}
+
+embedids_result_t embedids_add_datapoint(embedids_context_t *context, const char *metric_name,
+                                         embedids_metric_value_t value,
+                                         uint64_t timestamp_ms) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  embedids_metric_t *metric = &config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  if (metric->history == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  // Add data point to circular buffer
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = value;
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(context, config, datapoint);
+
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_metric_window(const embedids_metric_t *metric, uint32_t count,
+                                         embedids_datapoint_span_t *view) {
+  if (metric == NULL || view == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  memset(view, 0, sizeof(*view));
+  if (count > metric->current_size) {
+    count = metric->current_size;
+  }
+  if (count == 0) {
+    return EMBEDIDS_OK;
+  }
+
+  // The newest point sits just before write_index
+  if (count <= metric->write_index) {
+    view->first = &metric->history[metric->write_index - count];
+    view->first_count = count;
+    return EMBEDIDS_OK;
+  }
+
+  view->first_count = count - metric->write_index;
+  view->first = &metric->history[metric->max_history_size - view->first_count];
+  if (metric->write_index > 0) {
+    view->second = metric->history;
+    view->second_count = metric->write_index;
+  }
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_get_window(const embedids_metric_handle_t *handle, uint32_t count,
+                                      embedids_datapoint_span_t *view) {
+  if (handle == NULL || handle->config == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+  return embedids_metric_window(&handle->config->metric, count, view);
+}
+
+embedids_result_t embedids_peek_unacked(embedids_context_t *context, const char *metric_name,
+                                        embedids_datapoint_span_t *span) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL || span == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  // The unacknowledged points are the newest ones
+  return embedids_metric_window(&config->metric, config->metric.unacked, span);
+}
+
+embedids_result_t embedids_ack_datapoints(embedids_context_t *context,
+                                          const char *metric_name, uint32_t count) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  if (count > config->metric.unacked) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  config->metric.unacked -= count;
+  return EMBEDIDS_OK;
+}
+
+/* Look up a metric for a typed handle; the caller checks the type */
+static embedids_result_t resolve_handle(embedids_context_t *context,
+                                        const char *metric_name,
+                                        embedids_metric_handle_t *handle) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL || handle == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  if (config->metric.history == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  handle->context = context;
+  handle->config = config;
+  return EMBEDIDS_OK;
+}
+
+static embedids_result_t resolve_typed_handle(embedids_context_t *context,
+                                              const char *metric_name,
+                                              embedids_metric_type_t type,
+                                              embedids_metric_handle_t *handle) {
+  embedids_metric_handle_t resolved;
+  embedids_result_t result =
+      resolve_handle(context, metric_name, handle ? &resolved : NULL);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  if (resolved.config->metric.type != type) {
+    return EMBEDIDS_ERROR_METRIC_TYPE_MISMATCH;
+  }
+  *handle = resolved;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_get_u32_handle(embedids_context_t *context,
+                                          const char *metric_name,
+                                          embedids_u32_handle_t *handle) {
+  return resolve_typed_handle(context, metric_name, EMBEDIDS_METRIC_TYPE_UINT32,
+                              handle ? &handle->handle : NULL);
+}
+
+embedids_result_t embedids_get_u64_handle(embedids_context_t *context,
+                                          const char *metric_name,
+                                          embedids_u64_handle_t *handle) {
+  return resolve_typed_handle(context, metric_name, EMBEDIDS_METRIC_TYPE_UINT64,
+                              handle ? &handle->handle : NULL);
+}
+
+embedids_result_t embedids_get_bool_handle(embedids_context_t *context,
+                                           const char *metric_name,
+                                           embedids_bool_handle_t *handle) {
+  return resolve_typed_handle(context, metric_name, EMBEDIDS_METRIC_TYPE_BOOL,
+                              handle ? &handle->handle : NULL);
+}
+
+embedids_result_t embedids_get_enum_handle(embedids_context_t *context,
+                                           const char *metric_name,
+                                           embedids_enum_handle_t *handle) {
+  return resolve_typed_handle(context, metric_name, EMBEDIDS_METRIC_TYPE_ENUM,
+                              handle ? &handle->handle : NULL);
+}
+
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+embedids_result_t embedids_get_f32_handle(embedids_context_t *context,
+                                          const char *metric_name,
+                                          embedids_f32_handle_t *handle) {
+  embedids_metric_handle_t resolved;
+  embedids_result_t result =
+      resolve_handle(context, metric_name, handle ? &resolved : NULL);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  switch (resolved.config->metric.type) {
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    handle->handle = resolved;
+    return EMBEDIDS_OK;
+  default:
+    return EMBEDIDS_ERROR_METRIC_TYPE_MISMATCH;
+  }
+}
+
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+embedids_result_t embedids_get_f64_handle(embedids_context_t *context,
+                                          const char *metric_name,
+                                          embedids_f64_handle_t *handle) {
+  return resolve_typed_handle(context, metric_name, EMBEDIDS_METRIC_TYPE_DOUBLE,
+                              handle ? &handle->handle : NULL);
+}
+#endif
+#endif
+
+/* The typed adds write the union member directly: the handle's type was
+ * checked when it was resolved, so no per-call dispatch is needed. */
+embedids_result_t embedids_add_u32(const embedids_u32_handle_t *handle, uint32_t value,
+                                   uint64_t timestamp_ms) {
+  embedids_metric_t *metric = &handle->handle.config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = (embedids_metric_value_t){.u32 = value};
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(handle->handle.context, handle->handle.config, datapoint);
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_add_u64(const embedids_u64_handle_t *handle, uint64_t value,
+                                   uint64_t timestamp_ms) {
+  embedids_metric_t *metric = &handle->handle.config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = (embedids_metric_value_t){.u64 = value};
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(handle->handle.context, handle->handle.config, datapoint);
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_add_bool(const embedids_bool_handle_t *handle, bool value,
+                                    uint64_t timestamp_ms) {
+  embedids_metric_t *metric = &handle->handle.config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = (embedids_metric_value_t){.boolean = value};
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(handle->handle.context, handle->handle.config, datapoint);
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_add_enum(const embedids_enum_handle_t *handle, uint8_t value,
+                                    uint64_t timestamp_ms) {
+  embedids_metric_t *metric = &handle->handle.config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = (embedids_metric_value_t){.enum_val = value};
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(handle->handle.context, handle->handle.config, datapoint);
+  return EMBEDIDS_OK;
+}
+
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+embedids_result_t embedids_add_f32(const embedids_f32_handle_t *handle, float value,
+                                   uint64_t timestamp_ms) {
+  embedids_metric_t *metric = &handle->handle.config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = (embedids_metric_value_t){.f32 = value};
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(handle->handle.context, handle->handle.config, datapoint);
+  return EMBEDIDS_OK;
+}
+
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+embedids_result_t embedids_add_f64(const embedids_f64_handle_t *handle, double value,
+                                   uint64_t timestamp_ms) {
+  embedids_metric_t *metric = &handle->handle.config->metric;
+  embedids_result_t result = admit_datapoint(metric);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  embedids_metric_datapoint_t *datapoint = claim_datapoint(metric);
+  datapoint->value = (embedids_metric_value_t){.f64 = value};
+  datapoint->timestamp_ms = timestamp_ms;
+  commit_datapoint(handle->handle.context, handle->handle.config, datapoint);
+  return EMBEDIDS_OK;
+}
+#endif
+#endif
+
+embedids_result_t embedids_analyze_all(embedids_context_t *context) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  // Walk the slots directly; a name lookup per metric would pull every
+  // name through the cache only to find the slot already in hand
+  for (uint32_t i = 0; i < context->system_config->num_active_metrics;
+       i++) {
+    embedids_metric_config_t *config =
+        &context->system_config->metrics[i];
+    if (config->metric.enabled) {
+      embedids_result_t result = analyze_config(config, NULL);
+      if (result != EMBEDIDS_OK) {
+        return result; // Return first anomaly detected
+      }
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_analyze_metric(embedids_context_t *context, const char *metric_name) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  if (!config->metric.enabled) {
+    return EMBEDIDS_ERROR_METRIC_DISABLED;
+  }
+
+  return analyze_config(config, NULL);
+}
+
+embedids_result_t embedids_analyze_metric_detailed(embedids_context_t *context,
+                                                   const char *metric_name,
+                                                   embedids_detection_t *detection) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL || detection == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  if (!config->metric.enabled) {
+    return EMBEDIDS_ERROR_METRIC_DISABLED;
+  }
+
+  embedids_detection_clear(detection);
+  embedids_result_t result = analyze_config(config, detection);
+  detection->metric = (uint32_t)(config - context->system_config->metrics);
+  return result;
+}
+
+/* Store found, evicting the lowest score once all capacity entries are used */
+static void keep_strongest(embedids_detection_t *detections, uint32_t capacity,
+                           uint32_t stored, const embedids_detection_t *found) {
+  if (stored < capacity) {
+    detections[stored] = *found;
+    return;
+  }
+  if (capacity == 0) {
+    return;
+  }
+
+  uint32_t weakest = 0;
+  for (uint32_t i = 1; i < capacity; i++) {
+    if (detections[i].score < detections[weakest].score) {
+      weakest = i;
+    }
+  }
+  if (found->score <= detections[weakest].score) {
+    return;
+  }
+
+  // Close the gap so the kept entries stay in slot order
+  memmove(&detections[weakest], &detections[weakest + 1],
+          (capacity - weakest - 1) * sizeof(*detections));
+  detections[capacity - 1] = *found;
+}
+
+embedids_result_t embedids_analyze_all_detailed(embedids_context_t *context,
+                                                embedids_detection_t *detections,
+                                                uint32_t capacity, uint32_t *count) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if ((detections == NULL && capacity > 0) || count == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint32_t fired = 0;
+  embedids_result_t first = EMBEDIDS_OK;
+  for (uint32_t i = 0; i < context->system_config->num_active_metrics; i++) {
+    embedids_metric_config_t *config = &context->system_config->metrics[i];
+    if (!config->metric.enabled) {
+      continue;
+    }
+
+    embedids_detection_t found;
+    embedids_detection_clear(&found);
+    if (analyze_config(config, &found) == EMBEDIDS_OK) {
+      continue;
     }
-    if (config->check_max &&
-        latest_value.enum_val > config->max_threshold.enum_val) {
-      return EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
+    found.metric = i;
+    keep_strongest(detections, capacity, fired, &found);
+    if (fired++ == 0) {
+      first = found.result;
     }
-    break;
   }
 
-  return EMBEDIDS_OK;
+  *count = fired;
+  return first;
 }
 
-/* Built-in trend algorithm implementation */
-static embedids_result_t
-run_trend_algorithm(const embedids_metric_t *metric,
-                    const embedids_trend_config_t *config) {
-  if (metric->current_size < config->window_size || config->window_size < 2) {
-    return EMBEDIDS_OK; // Not enough data for trend analysis
+embedids_result_t embedids_analyze_next(embedids_context_t *context, uint32_t *cursor,
+                                        uint32_t *slot) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
   }
 
-  // TODO: Implement full trend analysis using linear regression
-  // This is a placeholder that needs proper implementation
-  (void)metric;  // Suppress unused parameter warning
-  (void)config;  // Suppress unused parameter warning
-  
-  return EMBEDIDS_OK;
-}
-
-embedids_result_t embedids_init(embedids_context_t *context, const embedids_system_config_t *config) {
-  if (context == NULL || config == NULL) {
+  if (cursor == NULL || slot == NULL) {
     return EMBEDIDS_ERROR_INVALID_PARAM;
   }
 
-  context->system_config = (embedids_system_config_t *)config;
-  context->initialized = true;
+  // Free slots are disabled, so only registered metrics are visited
+  while (*cursor < context->system_config->num_active_metrics) {
+    uint32_t index = (*cursor)++;
+    embedids_metric_config_t *config = &context->system_config->metrics[index];
+    if (config->metric.enabled) {
+      *slot = index;
+      return analyze_config(config, NULL);
+    }
+  }
 
-  return EMBEDIDS_OK;
+  return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
 }
 
-embedids_result_t embedids_add_datapoint(embedids_context_t *context, const char *metric_name,
-                                         embedids_metric_value_t value,
-                                         uint64_t timestamp_ms) {
-  if (!context || !context->initialized) {
-    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+embedids_severity_t embedids_severity_from_score(float score) {
+  if (!(score > 0.0f)) {
+    return EMBEDIDS_SEVERITY_NONE;
   }
+  if (score < 0.5f) {
+    return EMBEDIDS_SEVERITY_LOW;
+  }
+  if (score < 2.0f) {
+    return EMBEDIDS_SEVERITY_MEDIUM;
+  }
+  if (score < 10.0f) {
+    return EMBEDIDS_SEVERITY_HIGH;
+  }
+  return EMBEDIDS_SEVERITY_CRITICAL;
+}
 
-  if (metric_name == NULL) {
-    return EMBEDIDS_ERROR_INVALID_PARAM;
+/* Describe what algorithm index of config found, blaming the newest point */
+static void describe_detection(const embedids_metric_config_t *config,
+                               const embedids_algorithm_t *algorithm, uint32_t index,
+                               embedids_result_t result, float score,
+                               embedids_detection_t *detection) {
+  const embedids_metric_t *metric = &config->metric;
+  detection->result = result;
+  detection->severity = EMBEDIDS_SEVERITY_NONE;
+  detection->score = score;
+  detection->algorithm = index;
+  if (metric->current_size > 0) {
+    detection->point =
+        (metric->write_index > 0) ? metric->write_index - 1 : metric->max_history_size - 1;
+    detection->timestamp_ms = metric->history[detection->point].timestamp_ms;
   }
 
-  embedids_metric_config_t *config = find_metric_config(context, metric_name);
-  if (config == NULL) {
-    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  if (algorithm->type == EMBEDIDS_ALGORITHM_CUSTOM && algorithm->config.custom.detail) {
+    algorithm->config.custom.detail(metric, algorithm->config.custom.config,
+                                    embedids_custom_context(config, algorithm), detection);
+  } else if (algorithm->type == EMBEDIDS_ALGORITHM_STREAM && algorithm->config.stream.detail) {
+    algorithm->config.stream.detail(metric, algorithm->config.stream.config,
+                                    config->stream_instances[index].state, detection);
   }
 
-  embedids_metric_t *metric = &config->metric;
-  if (!metric->enabled) {
-    return EMBEDIDS_ERROR_METRIC_DISABLED;
+  if (detection->severity == EMBEDIDS_SEVERITY_NONE) {
+    detection->severity = embedids_severity_from_score(detection->score);
+  }
+}
+
+/* Hand a stream algorithm the points added since its previous call */
+static embedids_result_t run_stream_algorithm(const embedids_metric_t *metric,
+                                              const embedids_algorithm_t *algorithm,
+                                              embedids_stream_instance_t *instance) {
+  uint32_t fresh = metric->sequence - instance->seen;
+  if (fresh == 0) {
+    return EMBEDIDS_OK;
   }
+  instance->seen = metric->sequence;
 
-  if (metric->history == NULL) {
-    return EMBEDIDS_ERROR_INVALID_PARAM;
+  // Clamped to the stored points if the ring lapped since the last call
+  embedids_datapoint_span_t points;
+  embedids_metric_window(metric, fresh, &points);
+  return algorithm->config.stream.function(metric, &points, algorithm->config.stream.config,
+                                           instance->state);
+}
+
+void embedids_stream_restart(embedids_metric_config_t *config, bool reset) {
+  if (config->stream_instances == NULL) {
+    return;
   }
 
-  // Add data point to circular buffer
-  metric->history[metric->write_index].value = value;
-  metric->history[metric->write_index].timestamp_ms = timestamp_ms;
+  uint32_t count = 0;
+  const embedids_algorithm_t *algorithms = embedids_metric_algorithms(config, &count);
+  for (uint32_t i = 0; i < count; i++) {
+    const embedids_algorithm_t *algorithm = &algorithms[i];
+    if (algorithm->type != EMBEDIDS_ALGORITHM_STREAM) {
+      continue;
+    }
 
-  // Update buffer state
-  metric->write_index = (metric->write_index + 1) % metric->max_history_size;
-  if (metric->current_size < metric->max_history_size) {
-    metric->current_size++;
+    // Points already stored count as new
+    embedids_stream_instance_t *instance = &config->stream_instances[i];
+    instance->seen = config->metric.sequence - config->metric.current_size;
+
+    embedids_stream_state_fn hook = algorithm->config.stream.init;
+    if (reset && algorithm->config.stream.reset) {
+      hook = algorithm->config.stream.reset;
+    }
+    if (hook) {
+      hook(&config->metric, algorithm->config.stream.config, instance->state);
+    }
   }
+}
 
+/* Run algorithm index of config once; score is set on detection */
+static embedids_result_t run_algorithm(embedids_metric_config_t *config,
+                                       const embedids_algorithm_t *algorithm, uint32_t index,
+                                       float *score) {
+  switch (algorithm->type) {
+  case EMBEDIDS_ALGORITHM_THRESHOLD:
+    return run_threshold_algorithm(&config->metric, &algorithm->config.threshold, score);
+  case EMBEDIDS_ALGORITHM_TREND:
+    return run_trend_algorithm(&config->metric, &algorithm->config.trend);
+  case EMBEDIDS_ALGORITHM_CUSTOM:
+    if (algorithm->config.custom.function) {
+      return algorithm->config.custom.function(&config->metric, algorithm->config.custom.config,
+                                               embedids_custom_context(config, algorithm));
+    }
+    break;
+  case EMBEDIDS_ALGORITHM_STREAM:
+    if (algorithm->config.stream.function && config->stream_instances) {
+      return run_stream_algorithm(&config->metric, algorithm,
+                                  &config->stream_instances[index]);
+    }
+    break;
+  }
   return EMBEDIDS_OK;
 }
 
-embedids_result_t embedids_analyze_all(embedids_context_t *context) {
-  if (!context || !context->initialized) {
-    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+void embedids_alert_clear(embedids_metric_config_t *config) {
+  if (config->alerts == NULL) {
+    return;
   }
 
-  // Analyze all active metrics
-  for (uint32_t i = 0; i < context->system_config->num_active_metrics;
-       i++) {
-    embedids_metric_config_t *config =
-        &context->system_config->metrics[i];
-    if (config->metric.enabled) {
-      embedids_result_t result = embedids_analyze_metric(context, config->metric.name);
-      if (result != EMBEDIDS_OK) {
-        return result; // Return first anomaly detected
-      }
+  uint32_t count = 0;
+  embedids_metric_algorithms(config, &count);
+  for (uint32_t i = 0; i < count; i++) {
+    embedids_alert_state_t *alert = &config->alerts[i];
+    alert->last_report_ms = 0;
+    alert->hits = 0;
+    alert->misses = 0;
+    alert->reports = 0;
+    alert->seen = config->metric.sequence - config->metric.current_size;
+    alert->raised = false;
+    alert->announced = false;
+    alert->reported = false;
+  }
+}
+
+/* Advance an alert by one analysis; true if this verdict is reported */
+static bool alert_step(embedids_alert_state_t *alert, bool fired, float score,
+                       uint64_t now_ms) {
+  const embedids_alert_rule_t *rule = alert->rule;
+  bool hit = fired && score >= (alert->raised ? rule->clear_score : rule->raise_score);
+
+  if (!alert->raised) {
+    if (!hit) {
+      alert->hits = 0;
+      return false;
+    }
+    if (++alert->hits < rule->raise_after) {
+      return false;
+    }
+    alert->raised = true;
+    alert->announced = false;
+    alert->misses = 0;
+  } else if (!hit) {
+    if (++alert->misses >= rule->clear_after) {
+      // Clearing re-arms the alert
+      alert->raised = false;
+      alert->hits = 0;
+    }
+    return false;
+  } else {
+    alert->misses = 0;
+    if (rule->report_once && alert->announced) {
+      return false;
     }
   }
 
-  return EMBEDIDS_OK;
+  if (alert->reports > 0 && now_ms - alert->last_report_ms < rule->cooldown_ms) {
+    return false;
+  }
+  alert->announced = true;
+  alert->last_report_ms = now_ms;
+  alert->reports++;
+  return true;
 }
 
-embedids_result_t embedids_analyze_metric(embedids_context_t *context, const char *metric_name) {
-  if (!context || !context->initialized) {
-    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+/* Timestamp of a metric's newest point, 0 when it holds none */
+static uint64_t newest_timestamp(const embedids_metric_t *metric) {
+  if (metric->current_size == 0) {
+    return 0;
   }
+  uint32_t newest = (metric->write_index > 0) ? metric->write_index - 1
+                                              : metric->max_history_size - 1;
+  return metric->history[newest].timestamp_ms;
+}
 
-  if (metric_name == NULL) {
-    return EMBEDIDS_ERROR_INVALID_PARAM;
+/* Run algorithm index of config and pass its verdict through the metric's
+   alert state; found, which may be NULL, describes a reported detection */
+static embedids_result_t evaluate_algorithm(embedids_metric_config_t *config,
+                                            const embedids_algorithm_t *algorithm,
+                                            uint32_t index, embedids_detection_t *found) {
+  float score = 1.0f;
+  embedids_result_t result = run_algorithm(config, algorithm, index, &score);
+  embedids_alert_state_t *alert = config->alerts ? &config->alerts[index] : NULL;
+  if (alert == NULL || alert->rule == NULL) {
+    if (result != EMBEDIDS_OK && found) {
+      describe_detection(config, algorithm, index, result, score, found);
+    }
+    return result;
   }
 
-  embedids_metric_config_t *config = find_metric_config(context, metric_name);
-  if (config == NULL) {
-    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  // Score bands judge the described score, so describe first when they apply
+  embedids_detection_t described;
+  bool describe = result != EMBEDIDS_OK &&
+                  (found || alert->rule->raise_score > 0.0f || alert->rule->clear_score > 0.0f);
+  if (describe) {
+    embedids_detection_clear(&described);
+    describe_detection(config, algorithm, index, result, score, &described);
+    score = described.score;
   }
 
-  if (!config->metric.enabled) {
-    return EMBEDIDS_ERROR_METRIC_DISABLED;
+  // Points already judged keep their outcome
+  if (alert->seen != config->metric.sequence) {
+    alert->seen = config->metric.sequence;
+    alert->reported =
+        alert_step(alert, result != EMBEDIDS_OK, score, newest_timestamp(&config->metric));
+  }
+  if (!alert->reported || result == EMBEDIDS_OK) {
+    return EMBEDIDS_OK;
   }
+  if (found) {
+    *found = described;
+  }
+  return result;
+}
 
-  // Run all algorithms for this metric
-  for (uint32_t i = 0; i < config->num_algorithms; i++) {
-    embedids_algorithm_t *algorithm = &config->algorithms[i];
+/* Run every enabled algorithm and report only if the ensemble agrees */
+static embedids_result_t run_ensemble(embedids_metric_config_t *config,
+                                      const embedids_algorithm_t *algorithms, uint32_t count,
+                                      embedids_detection_t *detection) {
+  const embedids_ensemble_t *ensemble = config->ensemble;
+  embedids_detection_t strongest;
+  embedids_detection_clear(&strongest);
+  uint32_t voters = 0;
+  uint32_t votes = 0;
+  float weighted = 0.0f;
+
+  for (uint32_t i = 0; i < count; i++) {
+    const embedids_algorithm_t *algorithm = &algorithms[i];
     if (!algorithm->enabled) {
       continue;
     }
+    voters++;
 
-    embedids_result_t result = EMBEDIDS_OK;
+    embedids_detection_t found;
+    embedids_detection_clear(&found);
+    if (evaluate_algorithm(config, algorithm, i, &found) == EMBEDIDS_OK) {
+      continue;
+    }
+    votes++;
+    weighted += (ensemble->weights ? ensemble->weights[i] : 1.0f) * found.score;
+    if (strongest.result == EMBEDIDS_OK || found.score > strongest.score) {
+      strongest = found;
+    }
+  }
 
-    switch (algorithm->type) {
-    case EMBEDIDS_ALGORITHM_THRESHOLD:
-      result = run_threshold_algorithm(&config->metric,
-                                       &algorithm->config.threshold);
-      break;
-    case EMBEDIDS_ALGORITHM_TREND:
-      result = run_trend_algorithm(&config->metric, &algorithm->config.trend);
-      break;
-    case EMBEDIDS_ALGORITHM_CUSTOM:
-      if (algorithm->config.custom.function) {
-        result = algorithm->config.custom.function(
-            &config->metric, algorithm->config.custom.config,
-            algorithm->config.custom.context);
-      }
-      break;
+  bool agreed = false;
+  switch (ensemble->policy) {
+  case EMBEDIDS_ENSEMBLE_ANY:
+    agreed = votes > 0;
+    break;
+  case EMBEDIDS_ENSEMBLE_ALL:
+    agreed = votes > 0 && votes == voters;
+    break;
+  case EMBEDIDS_ENSEMBLE_K_OF_N:
+    agreed = votes >= ensemble->k;
+    break;
+  case EMBEDIDS_ENSEMBLE_WEIGHTED:
+    agreed = votes > 0 && weighted >= ensemble->threshold;
+    if (agreed) {
+      strongest.score = weighted;
+      strongest.severity = embedids_severity_from_score(weighted);
+    }
+    break;
+  }
+
+  if (!agreed) {
+    return EMBEDIDS_OK;
+  }
+  if (detection) {
+    *detection = strongest;
+  }
+  return strongest.result;
+}
+
+embedids_result_t embedids_run_algorithms(embedids_metric_config_t *config,
+                                          embedids_detection_t *detection) {
+  uint32_t count = 0;
+  const embedids_algorithm_t *algorithms = embedids_metric_algorithms(config, &count);
+  if (config->ensemble != NULL) {
+    return run_ensemble(config, algorithms, count, detection);
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    const embedids_algorithm_t *algorithm = &algorithms[i];
+    if (!algorithm->enabled) {
+      continue;
     }
 
+    embedids_result_t result = evaluate_algorithm(config, algorithm, i, detection);
     if (result != EMBEDIDS_OK) {
       return result; // Return first error detected
     }
@@ -265,7 +1399,7 @@ embedids_result_t embedids_get_trend(embedids_context_t *context, const char *me
     return EMBEDIDS_ERROR_INVALID_PARAM;
   }
 
-  embedids_metric_config_t *config = find_metric_config(context, metric_name);
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
   if (config == NULL) {
     return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
   }
@@ -376,12 +1510,123 @@ embedids_result_t embedids_get_trend(embedids_context_t *context, const char *me
   return EMBEDIDS_OK;
 }
 
+void embedids_summarize(const embedids_metric_t *metric, embedids_metric_summary_t *summary) {
+  memset(summary, 0, sizeof(*summary));
+  if (metric->current_size == 0) {
+    return;
+  }
+
+  // Walk from the oldest point to the newest
+  uint32_t oldest = (metric->write_index + metric->max_history_size -
+                     metric->current_size) % metric->max_history_size;
+  const embedids_metric_datapoint_t *first = &metric->history[oldest];
+  summary->min = first->value;
+  summary->max = first->value;
+  summary->first_timestamp_ms = first->timestamp_ms;
+
+  float sum = 0.0f;
+  uint32_t index = oldest;
+  for (uint32_t i = 0; i < metric->current_size; i++) {
+    const embedids_metric_datapoint_t *point = &metric->history[index];
+    if (embedids_value_less(metric->type, point->value, summary->min)) {
+      summary->min = point->value;
+    }
+    if (embedids_value_less(metric->type, summary->max, point->value)) {
+      summary->max = point->value;
+    }
+    sum += embedids_value_as_float(metric->type, point->value);
+    summary->last = point->value;
+    summary->last_timestamp_ms = point->timestamp_ms;
+    index = (index + 1 == metric->max_history_size) ? 0 : index + 1;
+  }
+
+  summary->count = metric->current_size;
+  summary->mean = sum / (float)metric->current_size;
+}
+
+embedids_result_t embedids_get_summary(embedids_context_t *context,
+                                       const char *metric_name,
+                                       embedids_metric_summary_t *summary) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL || summary == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  embedids_summarize(&config->metric, summary);
+  return EMBEDIDS_OK;
+}
+
 const char *embedids_get_version(void) { return EMBEDIDS_VERSION_STRING; }
 
 bool embedids_is_initialized(const embedids_context_t *context) { 
   return context ? context->initialized : false; 
 }
 
+static bool metric_type_supported(embedids_metric_type_t type) {
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    return true;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    return true;
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    return true;
+#endif
+#endif
+  default:
+    return false;
+  }
+}
+
+embedids_result_t embedids_validate_metric_definition(const embedids_metric_config_t *config) {
+  const embedids_metric_t *metric = &config->metric;
+  if (memchr(metric->name, '\0', EMBEDIDS_MAX_METRIC_NAME_LEN) == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NAME_TOO_LONG;
+  }
+
+  if (metric->name[0] == '\0' || !metric_type_supported(metric->type) ||
+      metric->max_history_size == 0) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  return validate_algorithms(config);
+}
+
+/* Check one slot; unnamed slots are free and always valid */
+static embedids_result_t validate_metric_config(const embedids_metric_config_t *config) {
+  const embedids_metric_t *metric = &config->metric;
+  if (metric->name[0] == '\0') {
+    return EMBEDIDS_OK;
+  }
+
+  embedids_result_t result = embedids_validate_metric_definition(config);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  if (metric->history == NULL || metric->current_size > metric->max_history_size ||
+      metric->write_index >= metric->max_history_size ||
+      metric->unacked > metric->current_size) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  return EMBEDIDS_OK;
+}
+
 embedids_result_t
 embedids_validate_config(const embedids_system_config_t *config) {
   if (!config) {
@@ -396,6 +1641,25 @@ embedids_validate_config(const embedids_system_config_t *config) {
     return EMBEDIDS_ERROR_CONFIG_INVALID;
   }
 
+  if (config->num_active_metrics > config->max_metrics) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  for (uint32_t i = 0; i < config->num_active_metrics; i++) {
+    embedids_result_t result = validate_metric_config(&config->metrics[i]);
+    if (result != EMBEDIDS_OK) {
+      return result;
+    }
+
+    // Names must be unique; validation runs once, so quadratic is fine
+    for (uint32_t j = 0; j < i && config->metrics[i].metric.name[0] != '\0'; j++) {
+      if (strncmp(config->metrics[i].metric.name, config->metrics[j].metric.name,
+                  EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
+        return EMBEDIDS_ERROR_CONFIG_INVALID;
+      }
+    }
+  }
+
   return EMBEDIDS_OK;
 }
 
@@ -449,11 +1713,52 @@ const char *embedids_get_error_string(embedids_result_t error_code) {
     return "Invalid timestamp";
   case EMBEDIDS_ERROR_THREAD_UNSAFE:
     return "Thread safety violation";
+  case EMBEDIDS_ERROR_IO:
+    return "I/O error";
   default:
     return "Unknown error";
   }
 }
 
+/*
+ * Readers only look at the current_size points before write_index, so
+ * clearing the indices hides every stored point without touching them.
+ * Block checksums and range indexes need no update either: an empty ring
+ * covers no points. Stream algorithms restart from the empty ring and
+ * alerts clear.
+ */
+static void reset_metric(embedids_metric_config_t *config) {
+  embedids_metric_t *metric = &config->metric;
+  metric->current_size = 0;
+  metric->write_index = 0;
+  metric->unacked = 0;
+  embedids_stream_restart(config, true);
+  embedids_alert_clear(config);
+}
+
+/* memset through a volatile pointer so dead-store elimination cannot drop it */
+static void *(*const volatile wipe_memset)(void *, int, size_t) = memset;
+
+static void wipe_metric(embedids_metric_config_t *config) {
+  embedids_metric_t *metric = &config->metric;
+  reset_metric(config);
+  if (metric->history) {
+    wipe_memset(metric->history, 0,
+                metric->max_history_size * sizeof(embedids_metric_datapoint_t));
+  }
+  if (metric->block_crcs) {
+    wipe_memset(metric->block_crcs, 0,
+                EMBEDIDS_INTEGRITY_BLOCKS(metric->max_history_size) * sizeof(uint32_t));
+    metric->stale_crc = 0;
+    metric->stale_prefix_crc = 0;
+  }
+  if (metric->range_index) {
+    wipe_memset(metric->range_index, 0,
+                EMBEDIDS_RANGE_INDEX_NODES(metric->max_history_size) *
+                    sizeof(embedids_range_aggregate_t));
+  }
+}
+
 embedids_result_t embedids_reset_all_metrics(embedids_context_t *context) {
   if (!context || !context->initialized) {
     return EMBEDIDS_ERROR_NOT_INITIALIZED;
@@ -462,17 +1767,81 @@ embedids_result_t embedids_reset_all_metrics(embedids_context_t *context) {
   // Reset all metric histories
   for (uint32_t i = 0; i < context->system_config->num_active_metrics;
        i++) {
-    embedids_metric_t *metric =
-        &context->system_config->metrics[i].metric;
-    metric->current_size = 0;
-    metric->write_index = 0;
+    reset_metric(&context->system_config->metrics[i]);
+  }
 
-    // Clear the history buffer if it exists
-    if (metric->history) {
-      memset(metric->history, 0,
-             metric->max_history_size * sizeof(embedids_metric_datapoint_t));
+  context->epoch++;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_wipe_history(embedids_context_t *context,
+                                        const char *metric_name) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name != NULL) {
+    embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+    if (config == NULL) {
+      return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+    }
+    wipe_metric(config);
+  } else {
+    for (uint32_t i = 0; i < context->system_config->num_active_metrics; i++) {
+      wipe_metric(&context->system_config->metrics[i]);
     }
   }
 
+  context->epoch++;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_reset_prefix(embedids_context_t *context,
+                                        const char *prefix) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (prefix == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  prefix_match_t match;
+  embedids_result_t result = match_prefix(context, prefix, &match);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  for (uint32_t i = 0; i < prefix_match_count(&match); i++) {
+    reset_metric(prefix_match_config(context, &match, i));
+  }
+
+  context->epoch++;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_get_epoch(const embedids_context_t *context, uint32_t *epoch) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (epoch == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  *epoch = context->epoch;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_set_datapoint_hook(embedids_context_t *context,
+                                              embedids_datapoint_hook_fn hook,
+                                              void *user_data) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  context->datapoint_hook = hook;
+  context->datapoint_hook_context = hook ? user_data : NULL;
+  context->slots_pinned = false;
   return EMBEDIDS_OK;
 }
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include <stdint.h>
+#include <string.h>
+
+_Static_assert((EMBEDIDS_CACHE_LINE_SIZE & (EMBEDIDS_CACHE_LINE_SIZE - 1)) == 0,
+               "EMBEDIDS_CACHE_LINE_SIZE must be a power of two");
+
+/* Arena bytes for one metric's ring and its optional tables */
+static size_t metric_bytes(const embedids_metric_config_t *config, uint32_t options) {
+  uint32_t points = config->metric.max_history_size;
+  if (points == 0) {
+    return 0;
+  }
+
+  size_t bytes = EMBEDIDS_ARENA_HISTORY_BYTES(points);
+  if (options & EMBEDIDS_ARENA_CHECKSUMS) {
+    bytes += EMBEDIDS_ARENA_ALIGN((size_t)EMBEDIDS_INTEGRITY_BLOCKS(points) * sizeof(uint32_t));
+  }
+  if (options & EMBEDIDS_ARENA_RANGE_INDEX) {
+    bytes += EMBEDIDS_ARENA_ALIGN((size_t)EMBEDIDS_RANGE_INDEX_NODES(points) *
+                                  sizeof(embedids_range_aggregate_t));
+  }
+  return bytes;
+}
+
+embedids_result_t embedids_arena_init(embedids_arena_t *arena, void *block, size_t size) {
+  if (arena == NULL || (block == NULL && size != 0)) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if ((uintptr_t)block % EMBEDIDS_CACHE_LINE_SIZE != 0) {
+    return EMBEDIDS_ERROR_ALIGNMENT_ERROR;
+  }
+
+  arena->base = (uint8_t *)block;
+  arena->size = size;
+  arena->used = 0;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_arena_alloc(embedids_arena_t *arena, size_t size, void **memory) {
+  if (arena == NULL || memory == NULL || size == 0) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (size > SIZE_MAX - EMBEDIDS_CACHE_LINE_SIZE) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  size_t bytes = EMBEDIDS_ARENA_ALIGN(size);
+  if (arena->base == NULL) {
+    // Measuring: only the running total matters
+    if (bytes > SIZE_MAX - arena->used) {
+      return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+    }
+    arena->used += bytes;
+    *memory = NULL;
+    return EMBEDIDS_OK;
+  }
+
+  if (bytes > arena->size - arena->used) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  *memory = arena->base + arena->used;
+  arena->used += bytes;
+  memset(*memory, 0, bytes);
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_arena_required(const embedids_metric_config_t *metrics,
+                                          uint32_t num_metrics, uint32_t options,
+                                          size_t *bytes) {
+  if (metrics == NULL || bytes == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t total = 0;
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    size_t needed = metric_bytes(&metrics[i], options);
+    if (needed > SIZE_MAX - total) {
+      return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+    }
+    total += needed;
+  }
+
+  *bytes = total;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_arena_alloc_histories(embedids_arena_t *arena,
+                                                 embedids_metric_config_t *metrics,
+                                                 uint32_t num_metrics, uint32_t options) {
+  if (arena == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t required = 0;
+  embedids_result_t result = embedids_arena_required(metrics, num_metrics, options, &required);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  // Check the whole set up front so a failure leaves every metric untouched
+  if (arena->base != NULL && required > arena->size - arena->used) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    embedids_metric_t *metric = &metrics[i].metric;
+    if (metric->max_history_size == 0) {
+      continue;
+    }
+
+    void *memory = NULL;
+    result = embedids_arena_alloc(arena,
+                                  (size_t)metric->max_history_size *
+                                      sizeof(embedids_metric_datapoint_t),
+                                  &memory);
+    if (result != EMBEDIDS_OK) {
+      return result;
+    }
+    metric->history = (embedids_metric_datapoint_t *)memory;
+
+    if (options & EMBEDIDS_ARENA_CHECKSUMS) {
+      result = embedids_arena_alloc(arena,
+                                    (size_t)EMBEDIDS_INTEGRITY_BLOCKS(metric->max_history_size) *
+                                        sizeof(uint32_t),
+                                    &memory);
+      if (result != EMBEDIDS_OK) {
+        return result;
+      }
+      metric->block_crcs = (uint32_t *)memory;
+    }
+
+    if (options & EMBEDIDS_ARENA_RANGE_INDEX) {
+      result = embedids_arena_alloc(arena,
+                                    (size_t)EMBEDIDS_RANGE_INDEX_NODES(metric->max_history_size) *
+                                        sizeof(embedids_range_aggregate_t),
+                                    &memory);
+      if (result != EMBEDIDS_OK) {
+        return result;
+      }
+      metric->range_index = (embedids_range_aggregate_t *)memory;
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
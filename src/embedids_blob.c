@@ -0,0 +1,281 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Blob layout:
+ *
+ *   blob_header_t (padded to BLOB_HEADER_SIZE)
+ *   embedids_metric_config_t[num_metrics]
+ *
+ * The config array is the exact in-memory image with history pointers
+ * cleared and ring indices at zero, so init only has to check the header
+ * and hand out history buffers. Once initialized, the array holds live
+ * ring state, so the checksum covers the header and each config as if its
+ * ring pointers and indices were still zero; the same blob can then be
+ * initialized again after cleanup.
+ */
+
+#define BLOB_MAGIC 0x42444945u /* "EIDB" */
+#define BLOB_VERSION 1u
+#define BLOB_BYTE_ORDER 0x01020304u
+#define BLOB_HEADER_SIZE 64u
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t layout_version;
+  uint32_t byte_order;
+  uint16_t header_size;
+  uint16_t name_len;
+  uint32_t config_size;
+  uint32_t datapoint_size;
+  uint32_t pointer_size;
+  uint32_t num_metrics;
+  uint32_t history_points;
+  uint32_t crc; /* over the header with crc zero, then the config images */
+} blob_header_t;
+
+#ifdef __cplusplus
+static_assert(sizeof(blob_header_t) <= BLOB_HEADER_SIZE, "blob header too large");
+#else
+_Static_assert(sizeof(blob_header_t) <= BLOB_HEADER_SIZE, "blob header too large");
+#endif
+
+/* Clear what init and ingest write into a config living in the blob */
+static void blob_clear_ring(embedids_metric_t *metric) {
+  metric->history = NULL;
+  metric->block_crcs = NULL;
+  metric->range_index = NULL;
+  metric->current_size = 0;
+  metric->write_index = 0;
+  metric->unacked = 0;
+  metric->sequence = 0;
+  metric->stale_crc = 0;
+  metric->stale_prefix_crc = 0;
+}
+
+/* Checksum of a blob as compiled, whatever ring state it holds now */
+static uint32_t blob_crc(const uint8_t *base, uint32_t num_metrics) {
+  uint8_t header[BLOB_HEADER_SIZE];
+  memcpy(header, base, BLOB_HEADER_SIZE);
+  memset(header + offsetof(blob_header_t, crc), 0, sizeof(uint32_t));
+  uint32_t crc = embedids_crc32c(0, header, BLOB_HEADER_SIZE);
+
+  // memcpy rather than assignment so padding bytes are checksummed as stored
+  const uint8_t *configs = base + BLOB_HEADER_SIZE;
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    embedids_metric_config_t image;
+    memcpy(&image, configs + (size_t)i * sizeof(image), sizeof(image));
+    blob_clear_ring(&image.metric);
+    crc = embedids_crc32c(crc, &image, sizeof(image));
+  }
+  return crc;
+}
+
+embedids_result_t embedids_config_to_blob(const embedids_metric_config_t *metrics,
+                                          uint32_t num_metrics, void *buffer,
+                                          size_t buffer_size, size_t *blob_size) {
+  if (metrics == NULL || blob_size == NULL || num_metrics == 0 ||
+      num_metrics > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint64_t history_points = 0;
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    const embedids_metric_config_t *config = &metrics[i];
+    if (config->metric.name[0] == '\0' ||
+        memchr(config->metric.name, '\0', EMBEDIDS_MAX_METRIC_NAME_LEN) == NULL) {
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+    if (config->metric.max_history_size == 0 ||
+        config->num_algorithms > EMBEDIDS_MAX_ALGORITHMS_PER_METRIC) {
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+    if (config->algorithm_set != NULL || config->ensemble != NULL || config->alerts != NULL) {
+      return EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED; // A pointer, like custom functions
+    }
+    for (uint32_t a = 0; a < config->num_algorithms; a++) {
+      if (config->algorithms[a].type == EMBEDIDS_ALGORITHM_CUSTOM ||
+          config->algorithms[a].type == EMBEDIDS_ALGORITHM_STREAM) {
+        return EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED;
+      }
+    }
+    history_points += config->metric.max_history_size;
+  }
+  if (history_points > UINT32_MAX) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  size_t configs_size = (size_t)num_metrics * sizeof(embedids_metric_config_t);
+  *blob_size = BLOB_HEADER_SIZE + configs_size;
+  if (buffer == NULL) {
+    return EMBEDIDS_OK;
+  }
+  if (buffer_size < *blob_size) {
+    return EMBEDIDS_ERROR_BUFFER_FULL;
+  }
+
+  uint8_t *base = (uint8_t *)buffer;
+  memset(base, 0, *blob_size);
+
+  embedids_metric_config_t *configs = (embedids_metric_config_t *)(base + BLOB_HEADER_SIZE);
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    // Configuration only: pointers and ring state stay zero in the image
+    embedids_metric_config_t *config = &configs[i];
+    memcpy(config->metric.name, metrics[i].metric.name, EMBEDIDS_MAX_METRIC_NAME_LEN);
+    config->metric.type = metrics[i].metric.type;
+    config->metric.max_history_size = metrics[i].metric.max_history_size;
+    config->metric.enabled = metrics[i].metric.enabled;
+    config->num_algorithms = metrics[i].num_algorithms;
+    for (uint32_t a = 0; a < metrics[i].num_algorithms; a++) {
+      config->algorithms[a].type = metrics[i].algorithms[a].type;
+      config->algorithms[a].enabled = metrics[i].algorithms[a].enabled;
+      config->algorithms[a].config = metrics[i].algorithms[a].config;
+    }
+  }
+
+  blob_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = BLOB_MAGIC;
+  header.version = BLOB_VERSION;
+  header.layout_version = EMBEDIDS_LAYOUT_VERSION;
+  header.byte_order = BLOB_BYTE_ORDER;
+  header.header_size = BLOB_HEADER_SIZE;
+  header.name_len = EMBEDIDS_MAX_METRIC_NAME_LEN;
+  header.config_size = sizeof(embedids_metric_config_t);
+  header.datapoint_size = sizeof(embedids_metric_datapoint_t);
+  header.pointer_size = sizeof(void *);
+  header.num_metrics = num_metrics;
+  header.history_points = (uint32_t)history_points;
+  memcpy(base, &header, sizeof(header));
+  header.crc = blob_crc(base, num_metrics);
+  memcpy(base, &header, sizeof(header));
+
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_config_blob_info(const void *blob, size_t blob_size,
+                                            embedids_config_blob_info_t *info) {
+  if (blob == NULL || info == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (blob_size < BLOB_HEADER_SIZE) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  blob_header_t header;
+  memcpy(&header, blob, sizeof(header));
+  if (header.magic != BLOB_MAGIC || header.version != BLOB_VERSION ||
+      header.layout_version != EMBEDIDS_LAYOUT_VERSION ||
+      header.byte_order != BLOB_BYTE_ORDER ||
+      header.header_size != BLOB_HEADER_SIZE ||
+      header.name_len != EMBEDIDS_MAX_METRIC_NAME_LEN ||
+      header.config_size != sizeof(embedids_metric_config_t) ||
+      header.datapoint_size != sizeof(embedids_metric_datapoint_t) ||
+      header.pointer_size != sizeof(void *) || header.num_metrics == 0 ||
+      header.num_metrics > EMBEDIDS_MAX_METRICS ||
+      blob_size != BLOB_HEADER_SIZE +
+                       (size_t)header.num_metrics * sizeof(embedids_metric_config_t)) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  if (blob_crc((const uint8_t *)blob, header.num_metrics) != header.crc) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  info->num_metrics = header.num_metrics;
+  info->history_points = header.history_points;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_init_from_blob(embedids_context_t *context,
+                                          embedids_system_config_t *system_config,
+                                          void *blob, size_t blob_size,
+                                          embedids_metric_datapoint_t *history_pool,
+                                          uint32_t pool_points) {
+  if (context == NULL || system_config == NULL || blob == NULL ||
+      history_pool == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if ((uintptr_t)blob % EMBEDIDS_CONFIG_BLOB_ALIGNMENT != 0) {
+    return EMBEDIDS_ERROR_ALIGNMENT_ERROR;
+  }
+
+  embedids_config_blob_info_t info;
+  embedids_result_t result = embedids_config_blob_info(blob, blob_size, &info);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  // Size the pool from the rings themselves, not the header's summary
+  embedids_metric_config_t *configs =
+      (embedids_metric_config_t *)((uint8_t *)blob + BLOB_HEADER_SIZE);
+  uint64_t needed = 0;
+  for (uint32_t i = 0; i < info.num_metrics; i++) {
+    needed += configs[i].metric.max_history_size;
+  }
+  if (needed != info.history_points) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+  if (pool_points < needed) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  // The checksum does not vouch for content: accept only what
+  // embedids_config_to_blob can produce, with no pointer to follow
+  for (uint32_t i = 0; i < info.num_metrics; i++) {
+    const embedids_metric_config_t *config = &configs[i];
+    if (config->algorithm_set != NULL || config->algorithm_state != NULL ||
+        config->stream_instances != NULL || config->ensemble != NULL ||
+        config->alerts != NULL ||
+        config->num_algorithms > EMBEDIDS_MAX_ALGORITHMS_PER_METRIC) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    for (uint32_t a = 0; a < config->num_algorithms; a++) {
+      if (config->algorithms[a].type == EMBEDIDS_ALGORITHM_CUSTOM ||
+          config->algorithms[a].type == EMBEDIDS_ALGORITHM_STREAM) {
+        return EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED;
+      }
+    }
+  }
+
+  embedids_metric_datapoint_t *next = history_pool;
+  for (uint32_t i = 0; i < info.num_metrics; i++) {
+    configs[i].metric.history = next;
+    configs[i].metric.block_crcs = NULL;
+    configs[i].metric.range_index = NULL;
+    next += configs[i].metric.max_history_size;
+  }
+
+  memset(system_config, 0, sizeof(*system_config));
+  system_config->metrics = configs;
+  system_config->max_metrics = info.num_metrics;
+  system_config->num_active_metrics = info.num_metrics;
+
+  result = embedids_validate_config(system_config);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  return embedids_init(context, system_config);
+}
@@ -0,0 +1,503 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <string.h>
+
+/*
+ * Frame layout:
+ *
+ *   u8 ENCODE_FRAME_HEADER, varint base_timestamp_ms
+ *   records, each starting with a u8 tag (embedids_record_kind_t)
+ *     ALERT:   varint metric_index, zigzag result, varint ts delta
+ *     SUMMARY: varint metric_index, u8 wire type, varint count,
+ *              varint first ts delta, varint last - first,
+ *              value min, value max, value last, f32 mean
+ *   u8 EMBEDIDS_RECORD_END
+ *
+ * Values are varints for integer types and raw little-endian bytes for
+ * floating point types. Types travel as fixed wire codes rather than
+ * embedids_metric_type_t ordinals, which shift with the floating point
+ * build options, so sender and receiver may be built differently.
+ */
+
+#define ENCODE_FRAME_HEADER 0xE1u
+#define ENCODE_MAX_VARINT 10u
+
+/* Wire codes for metric types, fixed across builds */
+enum {
+  ENCODE_TYPE_UINT32 = 0,
+  ENCODE_TYPE_UINT64 = 1,
+  ENCODE_TYPE_FLOAT = 2,
+  ENCODE_TYPE_DOUBLE = 3,
+  ENCODE_TYPE_PERCENTAGE = 4,
+  ENCODE_TYPE_RATE = 5,
+  ENCODE_TYPE_BOOL = 6,
+  ENCODE_TYPE_ENUM = 7
+};
+
+/* Scratch space large enough for the biggest record */
+#define ENCODE_MAX_RECORD (2u + 5u * ENCODE_MAX_VARINT + 3u * 8u + 4u)
+
+static size_t put_varint(uint8_t *out, uint64_t value) {
+  size_t n = 0;
+  while (value >= 0x80u) {
+    out[n++] = (uint8_t)(value | 0x80u);
+    value >>= 7;
+  }
+  out[n++] = (uint8_t)value;
+  return n;
+}
+
+static size_t put_le(uint8_t *out, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++) {
+    out[i] = (uint8_t)(value >> (8 * i));
+  }
+  return bytes;
+}
+
+static size_t put_f32(uint8_t *out, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return put_le(out, bits, sizeof(bits));
+}
+
+static bool type_to_wire(embedids_metric_type_t type, uint8_t *code) {
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    *code = ENCODE_TYPE_UINT32;
+    return true;
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    *code = ENCODE_TYPE_UINT64;
+    return true;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+    *code = ENCODE_TYPE_FLOAT;
+    return true;
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    *code = ENCODE_TYPE_DOUBLE;
+    return true;
+#endif
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+    *code = ENCODE_TYPE_PERCENTAGE;
+    return true;
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    *code = ENCODE_TYPE_RATE;
+    return true;
+#endif
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+    *code = ENCODE_TYPE_BOOL;
+    return true;
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    *code = ENCODE_TYPE_ENUM;
+    return true;
+  }
+  return false;
+}
+
+/* False for unknown codes and types this build cannot represent */
+static bool type_from_wire(uint8_t code, embedids_metric_type_t *type) {
+  switch (code) {
+  case ENCODE_TYPE_UINT32:
+    *type = EMBEDIDS_METRIC_TYPE_UINT32;
+    return true;
+  case ENCODE_TYPE_UINT64:
+    *type = EMBEDIDS_METRIC_TYPE_UINT64;
+    return true;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case ENCODE_TYPE_FLOAT:
+    *type = EMBEDIDS_METRIC_TYPE_FLOAT;
+    return true;
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case ENCODE_TYPE_DOUBLE:
+    *type = EMBEDIDS_METRIC_TYPE_DOUBLE;
+    return true;
+#endif
+  case ENCODE_TYPE_PERCENTAGE:
+    *type = EMBEDIDS_METRIC_TYPE_PERCENTAGE;
+    return true;
+  case ENCODE_TYPE_RATE:
+    *type = EMBEDIDS_METRIC_TYPE_RATE;
+    return true;
+#endif
+  case ENCODE_TYPE_BOOL:
+    *type = EMBEDIDS_METRIC_TYPE_BOOL;
+    return true;
+  case ENCODE_TYPE_ENUM:
+    *type = EMBEDIDS_METRIC_TYPE_ENUM;
+    return true;
+  default:
+    return false;
+  }
+}
+
+static size_t put_value(uint8_t *out, embedids_metric_type_t type,
+                        embedids_metric_value_t value) {
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    return put_varint(out, value.u32);
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    return put_varint(out, value.u64);
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    return put_f32(out, value.f32);
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE: {
+    uint64_t bits;
+    memcpy(&bits, &value.f64, sizeof(bits));
+    return put_le(out, bits, sizeof(bits));
+  }
+#endif
+#endif
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+    return put_varint(out, value.boolean ? 1u : 0u);
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    return put_varint(out, value.enum_val);
+  }
+  return 0;
+}
+
+/* Copy a finished record in, always leaving room for the end marker */
+static embedids_result_t commit_record(embedids_encoder_t *encoder,
+                                       const uint8_t *record, size_t length) {
+  if (encoder->capacity - encoder->length < length + 1) {
+    return EMBEDIDS_ERROR_BUFFER_FULL;
+  }
+  memcpy(encoder->buffer + encoder->length, record, length);
+  encoder->length += length;
+  encoder->records++;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_encoder_begin(embedids_encoder_t *encoder,
+                                         void *buffer, size_t capacity,
+                                         uint64_t base_timestamp_ms) {
+  if (encoder == NULL || buffer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint8_t header[1 + ENCODE_MAX_VARINT];
+  header[0] = ENCODE_FRAME_HEADER;
+  size_t length = 1 + put_varint(header + 1, base_timestamp_ms);
+  if (capacity < length + 1) {
+    return EMBEDIDS_ERROR_BUFFER_FULL;
+  }
+
+  encoder->buffer = (uint8_t *)buffer;
+  encoder->capacity = capacity;
+  memcpy(encoder->buffer, header, length);
+  encoder->length = length;
+  encoder->base_timestamp_ms = base_timestamp_ms;
+  encoder->records = 0;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_encode_alert(embedids_encoder_t *encoder,
+                                        uint32_t metric_index,
+                                        embedids_result_t result,
+                                        uint64_t timestamp_ms) {
+  if (encoder == NULL || encoder->buffer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+  if (timestamp_ms < encoder->base_timestamp_ms) {
+    return EMBEDIDS_ERROR_TIMESTAMP_INVALID;
+  }
+
+  // Results are small negative codes, zigzag keeps them to one byte
+  int32_t code = (int32_t)result;
+  uint32_t zigzag = ((uint32_t)code << 1) ^ (uint32_t)(code >> 31);
+
+  uint8_t record[ENCODE_MAX_RECORD];
+  size_t n = 0;
+  record[n++] = (uint8_t)EMBEDIDS_RECORD_ALERT;
+  n += put_varint(record + n, metric_index);
+  n += put_varint(record + n, zigzag);
+  n += put_varint(record + n, timestamp_ms - encoder->base_timestamp_ms);
+  return commit_record(encoder, record, n);
+}
+
+static embedids_result_t build_summary(const embedids_encoder_t *encoder,
+                                       uint32_t metric_index,
+                                       embedids_metric_type_t type,
+                                       const embedids_metric_summary_t *summary,
+                                       uint8_t *record, size_t *length) {
+  if (summary->count > 0 &&
+      (summary->first_timestamp_ms < encoder->base_timestamp_ms ||
+       summary->last_timestamp_ms < summary->first_timestamp_ms)) {
+    return EMBEDIDS_ERROR_TIMESTAMP_INVALID;
+  }
+
+  uint8_t code;
+  if (!type_to_wire(type, &code)) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t n = 0;
+  record[n++] = (uint8_t)EMBEDIDS_RECORD_SUMMARY;
+  n += put_varint(record + n, metric_index);
+  record[n++] = code;
+  n += put_varint(record + n, summary->count);
+  if (summary->count > 0) {
+    n += put_varint(record + n, summary->first_timestamp_ms - encoder->base_timestamp_ms);
+    n += put_varint(record + n, summary->last_timestamp_ms - summary->first_timestamp_ms);
+    n += put_value(record + n, type, summary->min);
+    n += put_value(record + n, type, summary->max);
+    n += put_value(record + n, type, summary->last);
+    n += put_f32(record + n, summary->mean);
+  }
+  *length = n;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_encode_summary(embedids_encoder_t *encoder,
+                                          uint32_t metric_index,
+                                          embedids_metric_type_t type,
+                                          const embedids_metric_summary_t *summary) {
+  if (encoder == NULL || encoder->buffer == NULL || summary == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint8_t record[ENCODE_MAX_RECORD];
+  size_t length = 0;
+  embedids_result_t result =
+      build_summary(encoder, metric_index, type, summary, record, &length);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+  return commit_record(encoder, record, length);
+}
+
+embedids_result_t embedids_encode_summaries(embedids_encoder_t *encoder,
+                                            embedids_context_t *context, uint32_t *cursor) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+  if (encoder == NULL || encoder->buffer == NULL || cursor == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  // Free slots are disabled, so only registered metrics are visited
+  const embedids_system_config_t *system = context->system_config;
+  for (; *cursor < system->num_active_metrics; (*cursor)++) {
+    const embedids_metric_t *metric = &system->metrics[*cursor].metric;
+    if (!metric->enabled || metric->current_size == 0) {
+      continue;
+    }
+
+    embedids_metric_summary_t summary;
+    embedids_summarize(metric, &summary);
+    embedids_result_t result = embedids_encode_summary(encoder, *cursor, metric->type, &summary);
+    if (result != EMBEDIDS_OK) {
+      return result; // Cursor stays on the metric that was not encoded
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_encoder_finish(embedids_encoder_t *encoder,
+                                          size_t *length) {
+  if (encoder == NULL || encoder->buffer == NULL || length == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  // Space for the end marker is reserved by every record
+  encoder->buffer[encoder->length] = (uint8_t)EMBEDIDS_RECORD_END;
+  *length = encoder->length + 1;
+  return EMBEDIDS_OK;
+}
+
+/* Decoding */
+
+static bool get_varint(embedids_decoder_t *decoder, uint64_t *value) {
+  uint64_t result = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (decoder->offset >= decoder->length) {
+      return false;
+    }
+    uint8_t byte = decoder->buffer[decoder->offset++];
+    result |= (uint64_t)(byte & 0x7fu) << shift;
+    if ((byte & 0x80u) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool get_u32(embedids_decoder_t *decoder, uint32_t *value) {
+  uint64_t wide;
+  if (!get_varint(decoder, &wide) || wide > UINT32_MAX) {
+    return false;
+  }
+  *value = (uint32_t)wide;
+  return true;
+}
+
+static bool get_le(embedids_decoder_t *decoder, uint64_t *value, size_t bytes) {
+  if (decoder->length - decoder->offset < bytes) {
+    return false;
+  }
+  uint64_t result = 0;
+  for (size_t i = 0; i < bytes; i++) {
+    result |= (uint64_t)decoder->buffer[decoder->offset++] << (8 * i);
+  }
+  *value = result;
+  return true;
+}
+
+static bool get_f32(embedids_decoder_t *decoder, float *value) {
+  uint64_t bits;
+  if (!get_le(decoder, &bits, sizeof(uint32_t))) {
+    return false;
+  }
+  uint32_t narrow = (uint32_t)bits;
+  memcpy(value, &narrow, sizeof(*value));
+  return true;
+}
+
+static bool get_value(embedids_decoder_t *decoder, embedids_metric_type_t type,
+                      embedids_metric_value_t *value) {
+  uint64_t raw;
+  memset(value, 0, sizeof(*value));
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    return get_u32(decoder, &value->u32);
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    return get_varint(decoder, &value->u64);
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    return get_f32(decoder, &value->f32);
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    if (!get_le(decoder, &raw, sizeof(raw))) {
+      return false;
+    }
+    memcpy(&value->f64, &raw, sizeof(raw));
+    return true;
+#endif
+#endif
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+    if (!get_varint(decoder, &raw) || raw > 1) {
+      return false;
+    }
+    value->boolean = raw != 0;
+    return true;
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    if (!get_varint(decoder, &raw) || raw > UINT8_MAX) {
+      return false;
+    }
+    value->enum_val = (uint8_t)raw;
+    return true;
+  }
+  return false;
+}
+
+embedids_result_t embedids_decoder_begin(embedids_decoder_t *decoder,
+                                         const void *buffer, size_t length) {
+  if (decoder == NULL || buffer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  decoder->buffer = (const uint8_t *)buffer;
+  decoder->length = length;
+  decoder->offset = 0;
+  if (length < 2 || decoder->buffer[0] != ENCODE_FRAME_HEADER) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+  decoder->offset = 1;
+  if (!get_varint(decoder, &decoder->base_timestamp_ms)) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+  return EMBEDIDS_OK;
+}
+
+static bool decode_summary(embedids_decoder_t *decoder, embedids_record_t *record) {
+  embedids_metric_summary_t *summary = &record->summary;
+  if (decoder->offset >= decoder->length) {
+    return false;
+  }
+  if (!type_from_wire(decoder->buffer[decoder->offset++], &record->type)) {
+    return false;
+  }
+  if (!get_u32(decoder, &summary->count)) {
+    return false;
+  }
+  if (summary->count == 0) {
+    return true;
+  }
+
+  uint64_t first_delta;
+  uint64_t span;
+  if (!get_varint(decoder, &first_delta) || !get_varint(decoder, &span)) {
+    return false;
+  }
+  summary->first_timestamp_ms = decoder->base_timestamp_ms + first_delta;
+  summary->last_timestamp_ms = summary->first_timestamp_ms + span;
+  return get_value(decoder, record->type, &summary->min) &&
+         get_value(decoder, record->type, &summary->max) &&
+         get_value(decoder, record->type, &summary->last) &&
+         get_f32(decoder, &summary->mean);
+}
+
+embedids_result_t embedids_decoder_next(embedids_decoder_t *decoder,
+                                        embedids_record_t *record) {
+  if (decoder == NULL || decoder->buffer == NULL || record == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  memset(record, 0, sizeof(*record));
+  if (decoder->offset >= decoder->length) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  uint8_t tag = decoder->buffer[decoder->offset++];
+  uint64_t value;
+  switch (tag) {
+  case EMBEDIDS_RECORD_END:
+    record->kind = EMBEDIDS_RECORD_END;
+    decoder->offset--; // stay on the end marker
+    return EMBEDIDS_OK;
+
+  case EMBEDIDS_RECORD_ALERT:
+    record->kind = EMBEDIDS_RECORD_ALERT;
+    if (!get_u32(decoder, &record->metric_index) || !get_varint(decoder, &value)) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    record->result = (embedids_result_t)((int32_t)(value >> 1) ^ -(int32_t)(value & 1));
+    if (!get_varint(decoder, &value)) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    record->timestamp_ms = decoder->base_timestamp_ms + value;
+    return EMBEDIDS_OK;
+
+  case EMBEDIDS_RECORD_SUMMARY:
+    record->kind = EMBEDIDS_RECORD_SUMMARY;
+    if (!get_u32(decoder, &record->metric_index) || !decode_summary(decoder, record)) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    return EMBEDIDS_OK;
+
+  default:
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Device block layout:
+ *
+ *   fleet_ring_t[num_metrics]
+ *   embedids_metric_datapoint_t[schema[0].max_history_size]
+ *   embedids_metric_datapoint_t[schema[1].max_history_size]
+ *   ...
+ *   algorithm state, schema[i].algorithm_state_size bytes for each metric
+ *   that has any, each padded to EMBEDIDS_FLEET_ARENA_ALIGNMENT
+ *
+ * Blocks follow each other at device_stride, so device d starts at
+ * arena + d * device_stride.
+ */
+
+typedef struct {
+  uint32_t current_size;
+  uint32_t write_index;
+} fleet_ring_t;
+
+/* Check the schema and compute the ring and state offsets and device block size */
+static embedids_result_t fleet_layout(const embedids_metric_config_t *schema,
+                                      uint32_t num_metrics, uint32_t *ring_offsets,
+                                      uint32_t *state_offsets, size_t *device_stride) {
+  if (schema == NULL || num_metrics == 0 || num_metrics > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint64_t offset = (uint64_t)num_metrics * sizeof(fleet_ring_t);
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    embedids_result_t result = embedids_validate_metric_definition(&schema[i]);
+    if (result != EMBEDIDS_OK) {
+      return result;
+    }
+
+    // Stream instances, alert states and custom contexts hold per-metric
+    // state that devices cannot share; per-device state goes in
+    // algorithm_state, which is copied into every block
+    if (schema[i].alerts != NULL) {
+      return EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED;
+    }
+    if (schema[i].algorithm_state != NULL && schema[i].algorithm_state_size == 0) {
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+    uint32_t count = 0;
+    const embedids_algorithm_t *algorithms = embedids_metric_algorithms(&schema[i], &count);
+    for (uint32_t a = 0; a < count; a++) {
+      if (algorithms[a].type == EMBEDIDS_ALGORITHM_STREAM ||
+          (algorithms[a].type == EMBEDIDS_ALGORITHM_CUSTOM &&
+           algorithms[a].config.custom.context != NULL)) {
+        return EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED;
+      }
+    }
+
+    // Names must be unique; validation runs once, so quadratic is fine
+    for (uint32_t j = 0; j < i; j++) {
+      if (strncmp(schema[i].metric.name, schema[j].metric.name,
+                  EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
+        return EMBEDIDS_ERROR_CONFIG_INVALID;
+      }
+    }
+
+    if (ring_offsets) {
+      ring_offsets[i] = (uint32_t)offset;
+    }
+    offset += (uint64_t)schema[i].metric.max_history_size * sizeof(embedids_metric_datapoint_t);
+    if (offset > UINT32_MAX) {
+      return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  // State goes after every ring so each block starts aligned
+  uint64_t align = EMBEDIDS_FLEET_ARENA_ALIGNMENT;
+  offset = (offset + align - 1) / align * align;
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    if (state_offsets) {
+      state_offsets[i] = (uint32_t)offset;
+    }
+    offset += ((uint64_t)schema[i].algorithm_state_size + align - 1) / align * align;
+    if (offset > UINT32_MAX) {
+      return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  *device_stride = (size_t)offset;
+  return EMBEDIDS_OK;
+}
+
+static uint8_t *fleet_device(const embedids_fleet_t *fleet, uint32_t device) {
+  return (uint8_t *)fleet->arena + (size_t)device * fleet->device_stride;
+}
+
+/* Empty every ring of a device and start its state from the schema */
+static void fleet_clear_device(const embedids_fleet_t *fleet, uint32_t device) {
+  uint8_t *block = fleet_device(fleet, device);
+  memset(block, 0, fleet->device_stride);
+  for (uint32_t m = 0; m < fleet->num_metrics; m++) {
+    const embedids_metric_config_t *config = &fleet->schema[m];
+    if (config->algorithm_state != NULL) {
+      memcpy(block + fleet->state_offsets[m], config->algorithm_state,
+             config->algorithm_state_size);
+    }
+  }
+}
+
+embedids_result_t embedids_fleet_memory(const embedids_metric_config_t *schema,
+                                        uint32_t num_metrics, uint32_t num_devices,
+                                        embedids_fleet_memory_t *report) {
+  if (report == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t stride = 0;
+  embedids_result_t result = fleet_layout(schema, num_metrics, NULL, NULL, &stride);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  if (num_devices > SIZE_MAX / stride) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  report->shared_bytes = sizeof(embedids_fleet_t) + num_metrics * sizeof(embedids_metric_config_t);
+  report->device_bytes = stride;
+  report->arena_bytes = (size_t)num_devices * stride;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_fleet_init(embedids_fleet_t *fleet,
+                                      const embedids_metric_config_t *schema,
+                                      uint32_t num_metrics, uint32_t num_devices,
+                                      void *arena, size_t arena_size) {
+  if (fleet == NULL || arena == NULL || num_devices == 0) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if ((uintptr_t)arena % EMBEDIDS_FLEET_ARENA_ALIGNMENT != 0) {
+    return EMBEDIDS_ERROR_ALIGNMENT_ERROR;
+  }
+
+  embedids_fleet_t fresh;
+  memset(&fresh, 0, sizeof(fresh));
+  embedids_result_t result = fleet_layout(schema, num_metrics, fresh.ring_offsets,
+                                          fresh.state_offsets, &fresh.device_stride);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  if (num_devices > arena_size / fresh.device_stride) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  fresh.schema = schema;
+  fresh.num_metrics = num_metrics;
+  fresh.num_devices = num_devices;
+  fresh.arena = arena;
+  for (uint32_t d = 0; d < num_devices; d++) {
+    fleet_clear_device(&fresh, d);
+  }
+  *fleet = fresh;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_fleet_find_metric(const embedids_fleet_t *fleet,
+                                             const char *metric_name,
+                                             uint32_t *metric_index) {
+  if (fleet == NULL || metric_name == NULL || metric_index == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (fleet->schema == NULL) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  for (uint32_t i = 0; i < fleet->num_metrics; i++) {
+    if (strncmp(fleet->schema[i].metric.name, metric_name, EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
+      *metric_index = i;
+      return EMBEDIDS_OK;
+    }
+  }
+  return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+}
+
+embedids_result_t embedids_fleet_add_datapoint(embedids_fleet_t *fleet, uint32_t device,
+                                               uint32_t metric_index,
+                                               embedids_metric_value_t value,
+                                               uint64_t timestamp_ms) {
+  if (fleet == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (fleet->schema == NULL) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (device >= fleet->num_devices || metric_index >= fleet->num_metrics) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  const embedids_metric_t *metric = &fleet->schema[metric_index].metric;
+  if (!metric->enabled) {
+    return EMBEDIDS_ERROR_METRIC_DISABLED;
+  }
+
+  uint8_t *block = fleet_device(fleet, device);
+  fleet_ring_t *ring = &((fleet_ring_t *)block)[metric_index];
+  embedids_metric_datapoint_t *history =
+      (embedids_metric_datapoint_t *)(block + fleet->ring_offsets[metric_index]);
+
+  history[ring->write_index].timestamp_ms = timestamp_ms;
+  history[ring->write_index].value = value;
+  history[ring->write_index].flags = 0;
+  history[ring->write_index].reserved = 0;
+
+  if (++ring->write_index == metric->max_history_size) {
+    ring->write_index = 0;
+  }
+  if (ring->current_size < metric->max_history_size) {
+    ring->current_size++;
+  }
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_fleet_analyze(embedids_fleet_t *fleet, uint32_t first_device,
+                                         uint32_t num_devices, embedids_result_t *results) {
+  if (fleet == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (fleet->schema == NULL) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (first_device > fleet->num_devices || num_devices > fleet->num_devices - first_device) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (results) {
+    for (uint32_t d = 0; d < num_devices; d++) {
+      results[d] = EMBEDIDS_OK;
+    }
+  }
+
+  // Detection of the lowest-numbered anomalous device, which is returned
+  uint32_t first_device_hit = num_devices;
+  embedids_result_t first_hit = EMBEDIDS_OK;
+
+  for (uint32_t m = 0; m < fleet->num_metrics; m++) {
+    if (!fleet->schema[m].metric.enabled) {
+      continue;
+    }
+
+    // One working copy per metric; only the ring fields and state change per
+    // device
+    embedids_metric_config_t view = fleet->schema[m];
+    view.metric.block_crcs = NULL;
+    view.metric.backpressure = false;
+    view.metric.unacked = 0;
+
+    for (uint32_t d = 0; d < num_devices; d++) {
+      if (results && results[d] != EMBEDIDS_OK) {
+        continue; // Already has its first detection
+      }
+
+      uint8_t *block = fleet_device(fleet, first_device + d);
+      const fleet_ring_t *ring = &((const fleet_ring_t *)block)[m];
+      view.metric.history = (embedids_metric_datapoint_t *)(block + fleet->ring_offsets[m]);
+      view.metric.current_size = ring->current_size;
+      view.metric.write_index = ring->write_index;
+      view.algorithm_state =
+          view.algorithm_state_size > 0 ? block + fleet->state_offsets[m] : NULL;
+
+      embedids_result_t result = embedids_run_algorithms(&view, NULL);
+      if (result == EMBEDIDS_OK) {
+        continue;
+      }
+      if (results) {
+        results[d] = result;
+      }
+      if (d < first_device_hit) {
+        first_device_hit = d;
+        first_hit = result;
+      }
+    }
+  }
+
+  return first_hit;
+}
+
+embedids_result_t embedids_fleet_reset_device(embedids_fleet_t *fleet, uint32_t device) {
+  if (fleet == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (fleet->schema == NULL) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (device >= fleet->num_devices) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  fleet_clear_device(fleet, device);
+  return EMBEDIDS_OK;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include "embedids_internal.h"
+
+/*
+ * History integrity
+ *
+ * The ring is split into blocks of EMBEDIDS_INTEGRITY_BLOCK_POINTS points.
+ * Points are written in order, so each block's CRC32C is extended point by
+ * point as it fills and restarts when the ring wraps back to its first
+ * point. At any time a block's checksum covers exactly its written points:
+ *
+ *   - the block holding write_index (if write_index is not its first
+ *     point) covers the points before write_index;
+ *   - every other block holding data covers all of its points.
+ *
+ * In a full ring the block being refilled still holds points from the
+ * previous lap after write_index. Those are covered by stale_crc, the
+ * block's CRC from that lap: stale_prefix_crc is extended with each old
+ * point just before it is overwritten, so continuing it over the stale
+ * tail must reproduce stale_crc.
+ */
+
+/* Number of points block b currently covers */
+static uint32_t block_points(const embedids_metric_t *metric, uint32_t block) {
+  uint32_t start = block * EMBEDIDS_INTEGRITY_BLOCK_POINTS;
+  uint32_t end = start + EMBEDIDS_INTEGRITY_BLOCK_POINTS;
+  if (end > metric->max_history_size) {
+    end = metric->max_history_size;
+  }
+
+  if (metric->write_index > start && metric->write_index < end) {
+    return metric->write_index - start; // Block being refilled
+  }
+  if (metric->current_size < metric->max_history_size && start >= metric->write_index) {
+    return 0; // Not reached yet
+  }
+  return end - start;
+}
+
+/* Stale points after write_index in the block being refilled, 0 if none */
+static uint32_t stale_points(const embedids_metric_t *metric) {
+  if (metric->current_size < metric->max_history_size ||
+      metric->write_index % EMBEDIDS_INTEGRITY_BLOCK_POINTS == 0) {
+    return 0;
+  }
+  uint32_t end = (metric->write_index / EMBEDIDS_INTEGRITY_BLOCK_POINTS + 1) *
+                 EMBEDIDS_INTEGRITY_BLOCK_POINTS;
+  if (end > metric->max_history_size) {
+    end = metric->max_history_size;
+  }
+  return end - metric->write_index;
+}
+
+embedids_result_t embedids_integrity_verify(const embedids_metric_t *metric) {
+  if (metric->block_crcs == NULL || metric->history == NULL) {
+    return EMBEDIDS_OK;
+  }
+
+  uint32_t blocks = EMBEDIDS_INTEGRITY_BLOCKS(metric->max_history_size);
+  for (uint32_t b = 0; b < blocks; b++) {
+    uint32_t points = block_points(metric, b);
+    if (points == 0) {
+      continue;
+    }
+    uint32_t crc = embedids_crc32c(0, &metric->history[b * EMBEDIDS_INTEGRITY_BLOCK_POINTS],
+                                   points * sizeof(embedids_metric_datapoint_t));
+    if (crc != metric->block_crcs[b]) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+  }
+
+  uint32_t stale = stale_points(metric);
+  if (stale > 0 &&
+      embedids_crc32c(metric->stale_prefix_crc, &metric->history[metric->write_index],
+                      stale * sizeof(embedids_metric_datapoint_t)) != metric->stale_crc) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+  return EMBEDIDS_OK;
+}
+
+void embedids_integrity_seal(embedids_metric_t *metric) {
+  if (metric->block_crcs == NULL || metric->history == NULL) {
+    return;
+  }
+
+  uint32_t blocks = EMBEDIDS_INTEGRITY_BLOCKS(metric->max_history_size);
+  for (uint32_t b = 0; b < blocks; b++) {
+    metric->block_crcs[b] =
+        embedids_crc32c(0, &metric->history[b * EMBEDIDS_INTEGRITY_BLOCK_POINTS],
+                        block_points(metric, b) * sizeof(embedids_metric_datapoint_t));
+  }
+
+  // The overwritten points are gone; restart the stale chain at write_index
+  metric->stale_prefix_crc = 0;
+  metric->stale_crc = embedids_crc32c(0, &metric->history[metric->write_index],
+                                      stale_points(metric) *
+                                          sizeof(embedids_metric_datapoint_t));
+}
+
+/* Apply fn to one metric by name, or to every registered metric */
+static embedids_result_t for_history(embedids_context_t *context, const char *metric_name,
+                                     embedids_result_t (*fn)(embedids_metric_t *)) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name != NULL) {
+    embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+    if (config == NULL) {
+      return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+    }
+    return fn(&config->metric);
+  }
+
+  for (uint32_t i = 0; i < context->system_config->num_active_metrics; i++) {
+    embedids_metric_t *metric = &context->system_config->metrics[i].metric;
+    if (metric->name[0] == '\0') {
+      continue; // Free slot
+    }
+    embedids_result_t result = fn(metric);
+    if (result != EMBEDIDS_OK) {
+      return result;
+    }
+  }
+  return EMBEDIDS_OK;
+}
+
+static embedids_result_t verify_one(embedids_metric_t *metric) {
+  return embedids_integrity_verify(metric);
+}
+
+static embedids_result_t seal_one(embedids_metric_t *metric) {
+  embedids_integrity_seal(metric);
+  embedids_range_build(metric);
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_verify_history(embedids_context_t *context,
+                                          const char *metric_name) {
+  return for_history(context, metric_name, verify_one);
+}
+
+embedids_result_t embedids_reseal_history(embedids_context_t *context,
+                                          const char *metric_name) {
+  return for_history(context, metric_name, seal_one);
+}
+
+embedids_result_t embedids_adopt_history(embedids_context_t *context,
+                                         const char *metric_name, uint32_t count) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  embedids_metric_t *metric = &config->metric;
+  if (metric->history == NULL || count > metric->max_history_size) {
+    return EMBEDIDS_ERROR_BUFFER_FULL;
+  }
+
+  // Windows into the old history are stale from here on
+  context->epoch++;
+  metric->current_size = count;
+  metric->write_index = (count == metric->max_history_size) ? 0 : count;
+  metric->unacked = 0;
+  metric->sequence += count;
+  seal_one(metric);
+  embedids_stream_restart(config, true);
+  embedids_alert_clear(config);
+  return EMBEDIDS_OK;
+}
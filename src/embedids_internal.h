@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Helpers shared between the library's translation units. Not installed.
+ */
+
+#ifndef EMBEDIDS_INTERNAL_H
+#define EMBEDIDS_INTERNAL_H
+
+#include "embedids.h"
+#include <stddef.h>
+
+/*
+ * Revision of the public struct layouts. Formats that store struct images
+ * (persistent history files) record it and refuse mismatches; bump it
+ * whenever embedids_metric_t, embedids_metric_config_t or their members
+ * change layout.
+ */
+#define EMBEDIDS_LAYOUT_VERSION 12u
+
+/* Find a metric configuration by name, NULL if absent */
+embedids_metric_config_t *
+embedids_find_metric_config(const embedids_context_t *context,
+                            const char *metric_name);
+
+/* Check a named metric's type, capacity and algorithms, not its ring state */
+embedids_result_t embedids_validate_metric_definition(const embedids_metric_config_t *config);
+
+/* Algorithms a metric runs: its shared set if it has one, otherwise its own */
+static inline const embedids_algorithm_t *
+embedids_metric_algorithms(const embedids_metric_config_t *config, uint32_t *count) {
+  if (config->algorithm_set != NULL) {
+    *count = config->algorithm_set->num_algorithms;
+    return config->algorithm_set->algorithms;
+  }
+  *count = config->num_algorithms;
+  return config->algorithms;
+}
+
+/* State handed to a custom algorithm: its own context, else the metric's block */
+static inline void *embedids_custom_context(const embedids_metric_config_t *config,
+                                            const embedids_algorithm_t *algorithm) {
+  return algorithm->config.custom.context ? algorithm->config.custom.context
+                                          : config->algorithm_state;
+}
+
+/* Convert a value to float for arithmetic that is shared across types */
+static inline float embedids_value_as_float(embedids_metric_type_t type,
+                                           embedids_metric_value_t value) {
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    return (float)value.u32;
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    return (float)value.u64;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    return value.f32;
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    return (float)value.f64;
+#endif
+#endif
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+    return value.boolean ? 1.0f : 0.0f;
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    return (float)value.enum_val;
+  }
+  return 0.0f;
+}
+
+/* Typed "a < b" on metric values */
+static inline bool embedids_value_less(embedids_metric_type_t type,
+                                       embedids_metric_value_t a,
+                                       embedids_metric_value_t b) {
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    return a.u32 < b.u32;
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    return a.u64 < b.u64;
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    return a.f32 < b.f32;
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    return a.f64 < b.f64;
+#endif
+#endif
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+    return !a.boolean && b.boolean;
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    return a.enum_val < b.enum_val;
+  }
+  return false;
+}
+
+/* Run a metric's enabled algorithms; returns the first detection and, if
+   detection is not NULL, describes it there */
+embedids_result_t embedids_run_algorithms(embedids_metric_config_t *config,
+                                          embedids_detection_t *detection);
+
+/* Summarize a metric's stored points, oldest to newest */
+void embedids_summarize(const embedids_metric_t *metric, embedids_metric_summary_t *summary);
+
+/* Reset a detection to "nothing found" */
+static inline void embedids_detection_clear(embedids_detection_t *detection) {
+  detection->result = EMBEDIDS_OK;
+  detection->severity = EMBEDIDS_SEVERITY_NONE;
+  detection->score = 0.0f;
+  detection->metric = EMBEDIDS_NO_INDEX;
+  detection->algorithm = EMBEDIDS_NO_INDEX;
+  detection->point = EMBEDIDS_NO_INDEX;
+  detection->timestamp_ms = 0;
+}
+
+/* Start stream algorithm instances over the stored points, via reset hooks if reset */
+void embedids_stream_restart(embedids_metric_config_t *config, bool reset);
+
+/* Clear a metric's alert states, keeping their rules */
+void embedids_alert_clear(embedids_metric_config_t *config);
+
+/* CRC32C (Castagnoli); pass 0 to start, the previous result to continue */
+uint32_t embedids_crc32c(uint32_t crc, const void *data, size_t len);
+
+/* Table-driven CRC32C, same result as embedids_crc32c */
+uint32_t embedids_crc32c_portable(uint32_t crc, const void *data, size_t len);
+
+/* true when embedids_crc32c uses CRC instructions */
+bool embedids_crc32c_accelerated(void);
+
+/* Extend the checksum of the block holding history[index], just written */
+static inline void embedids_integrity_update(embedids_metric_t *metric, uint32_t index) {
+  uint32_t block = index / EMBEDIDS_INTEGRITY_BLOCK_POINTS;
+  uint32_t crc = (index % EMBEDIDS_INTEGRITY_BLOCK_POINTS) ? metric->block_crcs[block] : 0;
+  metric->block_crcs[block] =
+      embedids_crc32c(crc, &metric->history[index], sizeof(embedids_metric_datapoint_t));
+}
+
+/* Fold history[index], about to be overwritten, into the checksum of the
+ * stale points still held by its block. Only a full ring has stale points;
+ * a block restarting keeps its last full-lap CRC in stale_crc. */
+static inline void embedids_integrity_retire(embedids_metric_t *metric, uint32_t index) {
+  if (metric->current_size < metric->max_history_size) {
+    return;
+  }
+  uint32_t crc = 0;
+  if (index % EMBEDIDS_INTEGRITY_BLOCK_POINTS == 0) {
+    metric->stale_crc = metric->block_crcs[index / EMBEDIDS_INTEGRITY_BLOCK_POINTS];
+  } else {
+    crc = metric->stale_prefix_crc;
+  }
+  metric->stale_prefix_crc =
+      embedids_crc32c(crc, &metric->history[index], sizeof(embedids_metric_datapoint_t));
+}
+
+/* Check every stored point of a metric against block_crcs */
+embedids_result_t embedids_integrity_verify(const embedids_metric_t *metric);
+
+/* Recompute block_crcs from the stored points */
+void embedids_integrity_seal(embedids_metric_t *metric);
+
+/* Refresh the range index path above history[index], just written */
+void embedids_range_update(embedids_metric_t *metric, uint32_t index);
+
+/* Rebuild range_index from the stored points */
+void embedids_range_build(embedids_metric_t *metric);
+
+#endif /* EMBEDIDS_INTERNAL_H */
@@ -0,0 +1,276 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * File layout:
+ *
+ *   persist_header_t
+ *   persist_entry_t[num_metrics]          (metric identity, ring offsets)
+ *   embedids_metric_config_t[num_metrics] (live configs, ring indices)
+ *   rings, each starting on a PERSIST_ALIGNMENT boundary
+ */
+
+#define PERSIST_MAGIC 0x50444945u /* "EIDP" */
+#define PERSIST_VERSION 1u
+#define PERSIST_BYTE_ORDER 0x01020304u
+#define PERSIST_ALIGNMENT 64u
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t layout_version;
+  uint32_t byte_order;
+  uint32_t num_metrics;
+  uint32_t name_len;
+  uint32_t config_size;
+  uint32_t datapoint_size;
+  uint32_t configs_offset;
+  uint64_t total_size;
+} persist_header_t;
+
+typedef struct {
+  char name[EMBEDIDS_MAX_METRIC_NAME_LEN];
+  uint32_t type;
+  uint32_t max_history_size;
+  uint64_t ring_offset;
+} persist_entry_t;
+
+static size_t align_up(size_t value) {
+  return (value + PERSIST_ALIGNMENT - 1) & ~(size_t)(PERSIST_ALIGNMENT - 1);
+}
+
+static size_t configs_offset(uint32_t num_metrics) {
+  return align_up(sizeof(persist_header_t) +
+                  (size_t)num_metrics * sizeof(persist_entry_t));
+}
+
+embedids_result_t
+embedids_persist_required_size(const embedids_metric_config_t *layout,
+                               uint32_t num_metrics, size_t *size) {
+  if (layout == NULL || size == NULL || num_metrics == 0 ||
+      num_metrics > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t total = align_up(configs_offset(num_metrics) +
+                          (size_t)num_metrics * sizeof(embedids_metric_config_t));
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    if (layout[i].metric.max_history_size == 0) {
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+    total = align_up(total + (size_t)layout[i].metric.max_history_size *
+                                 sizeof(embedids_metric_datapoint_t));
+  }
+
+  *size = total;
+  return EMBEDIDS_OK;
+}
+
+static bool entry_matches(const persist_entry_t *entry,
+                          const embedids_metric_config_t *layout) {
+  return strncmp(entry->name, layout->metric.name,
+                 EMBEDIDS_MAX_METRIC_NAME_LEN) == 0 &&
+         entry->type == (uint32_t)layout->metric.type &&
+         entry->max_history_size == layout->metric.max_history_size;
+}
+
+static void persist_create(uint8_t *base, size_t size,
+                           const embedids_metric_config_t *layout,
+                           uint32_t num_metrics) {
+  persist_header_t *header = (persist_header_t *)base;
+  header->magic = PERSIST_MAGIC;
+  header->version = PERSIST_VERSION;
+  header->layout_version = EMBEDIDS_LAYOUT_VERSION;
+  header->byte_order = PERSIST_BYTE_ORDER;
+  header->num_metrics = num_metrics;
+  header->name_len = EMBEDIDS_MAX_METRIC_NAME_LEN;
+  header->config_size = sizeof(embedids_metric_config_t);
+  header->datapoint_size = sizeof(embedids_metric_datapoint_t);
+  header->configs_offset = (uint32_t)configs_offset(num_metrics);
+  header->total_size = size;
+
+  persist_entry_t *entries = (persist_entry_t *)(base + sizeof(*header));
+  size_t ring_offset = align_up(header->configs_offset +
+                                (size_t)num_metrics * sizeof(embedids_metric_config_t));
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    strncpy(entries[i].name, layout[i].metric.name, EMBEDIDS_MAX_METRIC_NAME_LEN);
+    entries[i].type = (uint32_t)layout[i].metric.type;
+    entries[i].max_history_size = layout[i].metric.max_history_size;
+    entries[i].ring_offset = ring_offset;
+    ring_offset = align_up(ring_offset + (size_t)entries[i].max_history_size *
+                                             sizeof(embedids_metric_datapoint_t));
+
+    embedids_metric_config_t *config =
+        (embedids_metric_config_t *)(base + header->configs_offset) + i;
+    *config = layout[i];
+    config->metric.current_size = 0;
+    config->metric.write_index = 0;
+    config->metric.unacked = 0;
+  }
+}
+
+/* A commit interrupted between its write_index and current_size stores.
+ * The point itself was complete, so finishing the count repairs it. */
+static bool torn_commit(const embedids_metric_t *metric) {
+  return metric->current_size < metric->max_history_size &&
+         metric->write_index == (metric->current_size + 1) % metric->max_history_size;
+}
+
+static embedids_result_t persist_validate(const uint8_t *base, size_t size,
+                                          const embedids_metric_config_t *layout,
+                                          uint32_t num_metrics) {
+  const persist_header_t *header = (const persist_header_t *)base;
+  if (header->magic != PERSIST_MAGIC || header->version != PERSIST_VERSION ||
+      header->layout_version != EMBEDIDS_LAYOUT_VERSION ||
+      header->byte_order != PERSIST_BYTE_ORDER ||
+      header->num_metrics != num_metrics ||
+      header->name_len != EMBEDIDS_MAX_METRIC_NAME_LEN ||
+      header->config_size != sizeof(embedids_metric_config_t) ||
+      header->datapoint_size != sizeof(embedids_metric_datapoint_t) ||
+      header->configs_offset != configs_offset(num_metrics) ||
+      header->total_size != size) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  const persist_entry_t *entries = (const persist_entry_t *)(base + sizeof(*header));
+  const embedids_metric_config_t *configs =
+      (const embedids_metric_config_t *)(base + header->configs_offset);
+  size_t ring_offset = align_up(header->configs_offset +
+                                (size_t)num_metrics * sizeof(embedids_metric_config_t));
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    const embedids_metric_t *metric = &configs[i].metric;
+    if (!entry_matches(&entries[i], &layout[i]) ||
+        entries[i].ring_offset != ring_offset ||
+        metric->max_history_size != entries[i].max_history_size ||
+        metric->current_size > metric->max_history_size ||
+        metric->write_index >= metric->max_history_size ||
+        metric->unacked > metric->current_size ||
+        (metric->current_size < metric->max_history_size &&
+         metric->write_index != metric->current_size && !torn_commit(metric))) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    ring_offset = align_up(ring_offset + (size_t)entries[i].max_history_size *
+                                             sizeof(embedids_metric_datapoint_t));
+  }
+
+  return EMBEDIDS_OK;
+}
+
+/* Take configuration from layout while keeping the ring state in the file */
+static void persist_refresh(uint8_t *base, const embedids_metric_config_t *layout,
+                            uint32_t num_metrics) {
+  const persist_header_t *header = (const persist_header_t *)base;
+  const persist_entry_t *entries = (const persist_entry_t *)(base + sizeof(*header));
+  embedids_metric_config_t *configs =
+      (embedids_metric_config_t *)(base + header->configs_offset);
+
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    uint32_t current_size = configs[i].metric.current_size + torn_commit(&configs[i].metric);
+    uint32_t write_index = configs[i].metric.write_index;
+    uint32_t unacked = configs[i].metric.unacked;
+
+    configs[i] = layout[i];
+    configs[i].metric.history =
+        (embedids_metric_datapoint_t *)(base + entries[i].ring_offset);
+    configs[i].metric.current_size = current_size;
+    configs[i].metric.write_index = write_index;
+    configs[i].metric.unacked = configs[i].metric.backpressure ? unacked : 0;
+  }
+}
+
+embedids_result_t embedids_persist_open(embedids_persist_t *store, int fd,
+                                        const embedids_metric_config_t *layout,
+                                        uint32_t num_metrics) {
+  if (store == NULL || fd < 0) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t size = 0;
+  embedids_result_t result =
+      embedids_persist_required_size(layout, num_metrics, &size);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  memset(store, 0, sizeof(*store));
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  bool create = st.st_size == 0;
+  if (create) {
+    if (ftruncate(fd, (off_t)size) != 0) {
+      return EMBEDIDS_ERROR_IO;
+    }
+  } else if ((uint64_t)st.st_size != size) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  if (create) {
+    persist_create((uint8_t *)base, size, layout, num_metrics);
+  } else {
+    result = persist_validate((const uint8_t *)base, size, layout, num_metrics);
+    if (result != EMBEDIDS_OK) {
+      munmap(base, size);
+      return result;
+    }
+  }
+  persist_refresh((uint8_t *)base, layout, num_metrics);
+
+  const persist_header_t *header = (const persist_header_t *)base;
+  store->base = base;
+  store->size = size;
+  store->config.metrics =
+      (embedids_metric_config_t *)((uint8_t *)base + header->configs_offset);
+  store->config.max_metrics = num_metrics;
+  store->config.num_active_metrics = num_metrics;
+  store->reattached = !create;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_persist_sync(embedids_persist_t *store, bool wait) {
+  if (store == NULL || store->base == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (msync(store->base, store->size, wait ? MS_SYNC : MS_ASYNC) != 0) {
+    return EMBEDIDS_ERROR_IO;
+  }
+  return EMBEDIDS_OK;
+}
+
+void embedids_persist_close(embedids_persist_t *store) {
+  if (store && store->base) {
+    munmap(store->base, store->size);
+    memset(store, 0, sizeof(*store));
+  }
+}
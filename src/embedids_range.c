@@ -0,0 +1,189 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <string.h>
+
+/*
+ * Range index layout, for a ring of n = max_history_size slots:
+ *
+ *   node n + s     leaf for history[s]
+ *   node i < n     aggregate of nodes 2i and 2i + 1
+ *   node 0         unused
+ *
+ * Queries only combine nodes that lie wholly inside the requested slots,
+ * so stale leaves outside the live window never leak into a result and
+ * resetting a metric needs no index update.
+ */
+
+/* Fold from into into; a zero count on either side is the identity */
+static void range_merge(embedids_metric_type_t type, embedids_range_aggregate_t *into,
+                        const embedids_range_aggregate_t *from) {
+  if (from->count == 0) {
+    return;
+  }
+  if (into->count == 0) {
+    *into = *from;
+    return;
+  }
+  if (embedids_value_less(type, from->min, into->min)) {
+    into->min = from->min;
+  }
+  if (embedids_value_less(type, into->max, from->max)) {
+    into->max = from->max;
+  }
+  into->sum += from->sum;
+  into->count += from->count;
+}
+
+static void range_leaf(embedids_range_aggregate_t *leaf, embedids_metric_type_t type,
+                       embedids_metric_value_t value) {
+  leaf->min = value;
+  leaf->max = value;
+  leaf->sum = embedids_value_as_float(type, value);
+  leaf->count = 1;
+}
+
+static void range_pull(embedids_metric_t *metric, uint32_t node) {
+  embedids_range_aggregate_t *tree = metric->range_index;
+  tree[node] = tree[2 * node];
+  range_merge(metric->type, &tree[node], &tree[2 * node + 1]);
+}
+
+void embedids_range_update(embedids_metric_t *metric, uint32_t index) {
+  uint32_t node = metric->max_history_size + index;
+  range_leaf(&metric->range_index[node], metric->type, metric->history[index].value);
+  for (node >>= 1; node > 0; node >>= 1) {
+    range_pull(metric, node);
+  }
+}
+
+void embedids_range_build(embedids_metric_t *metric) {
+  if (metric->range_index == NULL || metric->history == NULL ||
+      metric->max_history_size == 0) {
+    return;
+  }
+
+  uint32_t n = metric->max_history_size;
+  memset(metric->range_index, 0, EMBEDIDS_RANGE_INDEX_NODES(n) * sizeof(*metric->range_index));
+
+  // Only live slots get leaves; the rest stay empty
+  uint32_t slot = (metric->write_index + n - metric->current_size) % n;
+  for (uint32_t i = 0; i < metric->current_size; i++) {
+    range_leaf(&metric->range_index[n + slot], metric->type, metric->history[slot].value);
+    slot = (slot + 1 == n) ? 0 : slot + 1;
+  }
+  for (uint32_t node = n - 1; node > 0; node--) {
+    range_pull(metric, node);
+  }
+}
+
+/* Aggregate physical slots [first, last) into result */
+static void range_slots(const embedids_metric_t *metric, uint32_t first, uint32_t last,
+                        embedids_range_aggregate_t *result) {
+  if (metric->range_index == NULL) {
+    embedids_range_aggregate_t leaf;
+    for (uint32_t slot = first; slot < last; slot++) {
+      range_leaf(&leaf, metric->type, metric->history[slot].value);
+      range_merge(metric->type, result, &leaf);
+    }
+    return;
+  }
+
+  const embedids_range_aggregate_t *tree = metric->range_index;
+  uint32_t n = metric->max_history_size;
+  for (first += n, last += n; first < last; first >>= 1, last >>= 1) {
+    if (first & 1) {
+      range_merge(metric->type, result, &tree[first++]);
+    }
+    if (last & 1) {
+      range_merge(metric->type, result, &tree[--last]);
+    }
+  }
+}
+
+/* Timestamp of the point at logical position i, 0 being the oldest */
+static uint64_t range_timestamp(const embedids_metric_t *metric, uint32_t oldest, uint32_t i) {
+  uint32_t slot = oldest + i;
+  if (slot >= metric->max_history_size) {
+    slot -= metric->max_history_size;
+  }
+  return metric->history[slot].timestamp_ms;
+}
+
+/* First logical position stamped at or after bound, or strictly after it if past */
+static uint32_t range_search(const embedids_metric_t *metric, uint32_t oldest, uint64_t bound,
+                             bool past) {
+  uint32_t low = 0;
+  uint32_t high = metric->current_size;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    uint64_t timestamp = range_timestamp(metric, oldest, mid);
+    if (past ? timestamp <= bound : timestamp < bound) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+embedids_result_t embedids_query_range(embedids_context_t *context,
+                                       const char *metric_name, uint64_t from_ms,
+                                       uint64_t to_ms,
+                                       embedids_range_aggregate_t *aggregate) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (metric_name == NULL || aggregate == NULL || from_ms > to_ms) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  const embedids_metric_config_t *config = embedids_find_metric_config(context, metric_name);
+  if (config == NULL) {
+    return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+  }
+
+  const embedids_metric_t *metric = &config->metric;
+  memset(aggregate, 0, sizeof(*aggregate));
+  if (metric->current_size == 0) {
+    return EMBEDIDS_OK;
+  }
+
+  uint32_t n = metric->max_history_size;
+  uint32_t oldest = (metric->write_index + n - metric->current_size) % n;
+  uint32_t begin = range_search(metric, oldest, from_ms, false);
+  uint32_t end = range_search(metric, oldest, to_ms, true);
+  if (begin >= end) {
+    return EMBEDIDS_OK;
+  }
+
+  // The logical run maps to at most two physical runs of the ring
+  uint32_t first = oldest + begin;
+  if (first >= n) {
+    first -= n;
+  }
+  uint32_t count = end - begin;
+  if (first + count <= n) {
+    range_slots(metric, first, first + count, aggregate);
+  } else {
+    range_slots(metric, first, n, aggregate);
+    range_slots(metric, 0, first + count - n, aggregate);
+  }
+  return EMBEDIDS_OK;
+}
@@ -0,0 +1,405 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Segment layout:
+ *
+ *   shm_header_t
+ *   shm_entry_t[num_metrics]      (metric identity, ring offsets)
+ *   shm_counter_t[num_metrics]    (seqlock counters, one cache line each)
+ *   rings, each starting on a SHM_ALIGNMENT boundary
+ *
+ * Each counter is a seqlock over the ring: twice the points published, plus
+ * one while the next point is being stored. To publish point n the writer
+ * stores 2n + 1, issues a release fence, writes slot n % capacity and then
+ * release-stores 2n + 2. A reader acquire-loads the counter, reads the
+ * points below it, issues an acquire fence and loads the counter again.
+ * Every point the second load shows as published or in progress may have
+ * been written during the read, so the view is intact only if none of
+ * their slots is in it. The header magic is stored last, so a segment is
+ * only visible to analyzers once it is completely laid out.
+ */
+
+#define SHM_MAGIC 0x4d444945u /* "EIDM" */
+#define SHM_VERSION 2u
+#define SHM_ALIGNMENT 64u
+
+typedef struct {
+  _Atomic uint32_t magic;
+  uint32_t version;
+  uint32_t num_metrics;
+  uint32_t name_len;
+  uint32_t datapoint_size;
+  uint32_t guard_points;
+  uint64_t total_size;
+} shm_header_t;
+
+typedef struct {
+  char name[EMBEDIDS_MAX_METRIC_NAME_LEN];
+  uint32_t type;
+  uint32_t capacity;
+  uint64_t ring_offset;
+} shm_entry_t;
+
+typedef struct {
+  _Atomic uint64_t sequence; /* 2 * published, odd while a point is stored */
+  uint8_t padding[SHM_ALIGNMENT - sizeof(uint64_t)];
+} shm_counter_t;
+
+static size_t align_up(size_t value) {
+  return (value + SHM_ALIGNMENT - 1) & ~(size_t)(SHM_ALIGNMENT - 1);
+}
+
+static size_t counters_offset(uint32_t num_metrics) {
+  return align_up(sizeof(shm_header_t) + (size_t)num_metrics * sizeof(shm_entry_t));
+}
+
+static shm_entry_t *shm_entries(const void *base) {
+  return (shm_entry_t *)((uint8_t *)base + sizeof(shm_header_t));
+}
+
+static shm_counter_t *shm_counters(const void *base, uint32_t num_metrics) {
+  return (shm_counter_t *)((uint8_t *)base + counters_offset(num_metrics));
+}
+
+embedids_result_t embedids_shm_writer_create(embedids_shm_writer_t *writer,
+                                             const char *shm_name,
+                                             const embedids_metric_config_t *layout,
+                                             uint32_t num_metrics) {
+  if (writer == NULL || shm_name == NULL || layout == NULL || num_metrics == 0 ||
+      num_metrics > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t size = align_up(counters_offset(num_metrics) +
+                         (size_t)num_metrics * sizeof(shm_counter_t));
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    if (layout[i].metric.max_history_size <= EMBEDIDS_SHM_GUARD_POINTS) {
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+    size = align_up(size + (size_t)layout[i].metric.max_history_size *
+                               sizeof(embedids_metric_datapoint_t));
+  }
+
+  memset(writer, 0, sizeof(*writer));
+
+  // Replace any stale segment; attached analyzers keep the old object
+  (void)shm_unlink(shm_name);
+  int fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  if (ftruncate(fd, (off_t)size) != 0) {
+    close(fd);
+    shm_unlink(shm_name);
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    shm_unlink(shm_name);
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  shm_header_t *header = (shm_header_t *)base;
+  header->version = SHM_VERSION;
+  header->num_metrics = num_metrics;
+  header->name_len = EMBEDIDS_MAX_METRIC_NAME_LEN;
+  header->datapoint_size = sizeof(embedids_metric_datapoint_t);
+  header->guard_points = EMBEDIDS_SHM_GUARD_POINTS;
+  header->total_size = size;
+
+  shm_entry_t *entries = shm_entries(base);
+  shm_counter_t *counters = shm_counters(base, num_metrics);
+  size_t ring_offset = align_up(counters_offset(num_metrics) +
+                                (size_t)num_metrics * sizeof(shm_counter_t));
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    strncpy(entries[i].name, layout[i].metric.name, EMBEDIDS_MAX_METRIC_NAME_LEN);
+    entries[i].type = (uint32_t)layout[i].metric.type;
+    entries[i].capacity = layout[i].metric.max_history_size;
+    entries[i].ring_offset = ring_offset;
+    atomic_init(&counters[i].sequence, 0);
+    ring_offset = align_up(ring_offset + (size_t)entries[i].capacity *
+                                             sizeof(embedids_metric_datapoint_t));
+  }
+
+  atomic_store_explicit(&header->magic, SHM_MAGIC, memory_order_release);
+
+  writer->base = base;
+  writer->size = size;
+  writer->num_metrics = num_metrics;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_shm_writer_find(const embedids_shm_writer_t *writer,
+                                           const char *metric_name,
+                                           uint32_t *index) {
+  if (writer == NULL || writer->base == NULL || metric_name == NULL ||
+      index == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  const shm_entry_t *entries = shm_entries(writer->base);
+  for (uint32_t i = 0; i < writer->num_metrics; i++) {
+    if (strncmp(entries[i].name, metric_name, EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
+      *index = i;
+      return EMBEDIDS_OK;
+    }
+  }
+  return EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+}
+
+embedids_result_t embedids_shm_write(embedids_shm_writer_t *writer,
+                                     uint32_t index,
+                                     embedids_metric_value_t value,
+                                     uint64_t timestamp_ms) {
+  if (writer == NULL || writer->base == NULL || index >= writer->num_metrics) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  const shm_entry_t *entry = &shm_entries(writer->base)[index];
+  shm_counter_t *counter = &shm_counters(writer->base, writer->num_metrics)[index];
+
+  // Single writer: only this process ever stores to the sequence, which is
+  // even between writes
+  uint64_t sequence = atomic_load_explicit(&counter->sequence, memory_order_relaxed);
+  embedids_metric_datapoint_t *ring =
+      (embedids_metric_datapoint_t *)((uint8_t *)writer->base + entry->ring_offset);
+  embedids_metric_datapoint_t *datapoint = &ring[(sequence / 2) % entry->capacity];
+
+  // Mark the slot busy before touching it
+  atomic_store_explicit(&counter->sequence, sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  datapoint->timestamp_ms = timestamp_ms;
+  datapoint->value = value;
+  datapoint->flags = 0;
+
+  atomic_store_explicit(&counter->sequence, sequence + 2, memory_order_release);
+  return EMBEDIDS_OK;
+}
+
+void embedids_shm_writer_close(embedids_shm_writer_t *writer) {
+  if (writer && writer->base) {
+    munmap(writer->base, writer->size);
+    memset(writer, 0, sizeof(*writer));
+  }
+}
+
+embedids_result_t embedids_shm_analyzer_attach(embedids_shm_analyzer_t *analyzer,
+                                               const char *shm_name,
+                                               embedids_metric_config_t *metrics,
+                                               uint32_t num_metrics) {
+  if (analyzer == NULL || shm_name == NULL || metrics == NULL ||
+      num_metrics > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  memset(analyzer, 0, sizeof(*analyzer));
+
+  int fd = shm_open(shm_name, O_RDONLY, 0);
+  if (fd < 0) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(shm_header_t)) {
+    close(fd);
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  shm_header_t *header = (shm_header_t *)base;
+  if (atomic_load_explicit(&header->magic, memory_order_acquire) != SHM_MAGIC) {
+    munmap(base, size);
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  // The writer may still change the header; read each field once
+  uint32_t segment_metrics = header->num_metrics;
+  uint32_t guard_points = header->guard_points;
+  if (header->version != SHM_VERSION ||
+      header->name_len != EMBEDIDS_MAX_METRIC_NAME_LEN ||
+      header->datapoint_size != sizeof(embedids_metric_datapoint_t) ||
+      header->total_size != size || segment_metrics == 0 ||
+      segment_metrics > EMBEDIDS_MAX_METRICS ||
+      counters_offset(segment_metrics) + (size_t)segment_metrics * sizeof(shm_counter_t) >
+          size) {
+    munmap(base, size);
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  const shm_entry_t *entries = shm_entries(base);
+  size_t rings_offset = counters_offset(segment_metrics) +
+                        (size_t)segment_metrics * sizeof(shm_counter_t);
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    embedids_metric_config_t *config = &metrics[i];
+    uint32_t slot = segment_metrics;
+    shm_entry_t entry;
+    for (uint32_t s = 0; s < segment_metrics; s++) {
+      memcpy(&entry, &entries[s], sizeof(entry));
+      if (strncmp(entry.name, config->metric.name, EMBEDIDS_MAX_METRIC_NAME_LEN) == 0) {
+        slot = s;
+        break;
+      }
+    }
+
+    if (slot == segment_metrics || entry.type != (uint32_t)config->metric.type) {
+      munmap(base, size);
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+
+    // The ring must lie inside the mapping, after the counters, and be
+    // larger than the guard zone
+    if (entry.capacity <= guard_points || entry.ring_offset < rings_offset ||
+        entry.ring_offset > size ||
+        entry.ring_offset % _Alignof(embedids_metric_datapoint_t) != 0 ||
+        (uint64_t)entry.capacity * sizeof(embedids_metric_datapoint_t) >
+            size - entry.ring_offset) {
+      munmap(base, size);
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+
+    // Stateful metrics must not run on a view that may still tear
+    bool private_copy = config->metric.history != NULL && config->metric.max_history_size > 0;
+    if (!private_copy && (config->stream_instances != NULL || config->alerts != NULL)) {
+      munmap(base, size);
+      return EMBEDIDS_ERROR_CONFIG_INVALID;
+    }
+
+    analyzer->slots[i] = (uint16_t)slot;
+    analyzer->capacities[i] = entry.capacity;
+    analyzer->rings[i] =
+        (const embedids_metric_datapoint_t *)((const uint8_t *)base + entry.ring_offset);
+  }
+
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    embedids_metric_t *metric = &metrics[i].metric;
+    if (metric->history == NULL || metric->max_history_size == 0) {
+      metric->history = (embedids_metric_datapoint_t *)analyzer->rings[i];
+      metric->max_history_size = analyzer->capacities[i];
+    }
+    metric->current_size = 0;
+    metric->write_index = 0;
+    metric->sequence = 0;
+    embedids_stream_restart(&metrics[i], false);
+    embedids_alert_clear(&metrics[i]);
+  }
+
+  analyzer->base = base;
+  analyzer->size = size;
+  analyzer->metrics = metrics;
+  analyzer->num_metrics = num_metrics;
+  analyzer->guard_points = guard_points;
+  analyzer->counters = shm_counters(base, segment_metrics);
+  return EMBEDIDS_OK;
+}
+
+/* Copy the count points published before published into the metric's own ring */
+static void shm_copy_view(embedids_metric_t *metric, const embedids_metric_datapoint_t *ring,
+                          uint32_t capacity, uint64_t published, uint32_t count) {
+  uint32_t start = (uint32_t)((published - count) % capacity);
+  uint32_t first = capacity - start < count ? capacity - start : count;
+  memcpy(metric->history, &ring[start], first * sizeof(*ring));
+  memcpy(metric->history + first, ring, (count - first) * sizeof(*ring));
+  metric->write_index = count % metric->max_history_size;
+  metric->current_size = count;
+  metric->sequence = (uint32_t)published;
+}
+
+embedids_result_t embedids_shm_analyze_all(embedids_shm_analyzer_t *analyzer) {
+  if (analyzer == NULL || analyzer->base == NULL) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  shm_counter_t *counters = (shm_counter_t *)analyzer->counters;
+  for (uint32_t i = 0; i < analyzer->num_metrics; i++) {
+    embedids_metric_config_t *config = &analyzer->metrics[i];
+    if (!config->metric.enabled) {
+      continue;
+    }
+
+    embedids_metric_t *metric = &config->metric;
+    const embedids_metric_datapoint_t *ring = analyzer->rings[i];
+    uint32_t capacity = analyzer->capacities[i];
+    uint32_t visible = capacity - analyzer->guard_points;
+    bool private_copy = metric->history != ring;
+    if (private_copy && visible > metric->max_history_size) {
+      visible = metric->max_history_size;
+    }
+    _Atomic uint64_t *sequence = &counters[analyzer->slots[i]].sequence;
+
+    embedids_result_t result = EMBEDIDS_ERROR_THREAD_UNSAFE;
+    for (uint32_t attempt = 0; attempt <= EMBEDIDS_SHM_MAX_RETRIES; attempt++) {
+      // Points below before are complete; one in progress is not viewed
+      uint64_t before = atomic_load_explicit(sequence, memory_order_acquire) / 2;
+      uint32_t count = before < visible ? (uint32_t)before : visible;
+
+      embedids_result_t candidate = EMBEDIDS_OK;
+      if (private_copy) {
+        shm_copy_view(metric, ring, capacity, before, count);
+      } else {
+        metric->write_index = (uint32_t)(before % capacity);
+        metric->current_size = count;
+        metric->sequence = (uint32_t)before;
+        candidate = embedids_run_algorithms(config, NULL);
+      }
+
+      // Points claimed since, including one still being stored, may have
+      // overwritten their slots; the oldest viewed point sits in the slot of
+      // point before + capacity - count, so that one must not be claimed
+      atomic_thread_fence(memory_order_acquire);
+      uint64_t claimed = (atomic_load_explicit(sequence, memory_order_relaxed) + 1) / 2;
+      if (claimed - before <= capacity - count) {
+        // A private copy is run only once it is known to be intact, so
+        // stateful algorithms step exactly once per pass
+        result = private_copy ? embedids_run_algorithms(config, NULL) : candidate;
+        break;
+      }
+    }
+
+    if (result != EMBEDIDS_OK) {
+      return result;
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
+
+void embedids_shm_analyzer_detach(embedids_shm_analyzer_t *analyzer) {
+  if (analyzer && analyzer->base) {
+    munmap((void *)analyzer->base, analyzer->size);
+    memset(analyzer, 0, sizeof(*analyzer));
+  }
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "embedids.h"
+#include "embedids_internal.h"
+#include <string.h>
+
+/*
+ * Snapshot layout (native byte order, no alignment requirement):
+ *
+ *   snapshot_header_t
+ *   for each metric:
+ *     snapshot_metric_t
+ *     embedids_metric_datapoint_t[history_points]   (the ring, as is)
+ *     for each saved algorithm state:
+ *       snapshot_state_t
+ *       uint8_t[size]
+ *
+ * The CRC covers every byte after the header.
+ */
+
+#define SNAPSHOT_MAGIC 0x53444945u /* "EIDS" */
+#define SNAPSHOT_VERSION 2u
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t name_len;
+  uint32_t total_size;
+  uint32_t num_metrics;
+  uint32_t datapoint_size;
+  uint32_t crc;
+} snapshot_header_t;
+
+typedef struct {
+  char name[EMBEDIDS_MAX_METRIC_NAME_LEN];
+  uint32_t type;
+  uint32_t max_history_size;
+  uint32_t history_points;
+  uint32_t current_size;
+  uint32_t write_index;
+  uint32_t unacked;
+  uint32_t num_states;
+} snapshot_metric_t;
+
+typedef struct {
+  uint32_t algorithm_index;
+  uint32_t size;
+} snapshot_state_t;
+
+static uint32_t snapshot_metric_count(const embedids_context_t *context) {
+  const embedids_system_config_t *system = context->system_config;
+  return system->metrics ? system->num_active_metrics : 0;
+}
+
+static uint32_t history_points(const embedids_metric_t *metric) {
+  return metric->history ? metric->max_history_size : 0;
+}
+
+static bool has_saved_state(const embedids_algorithm_t *algorithm) {
+  return algorithm->type == EMBEDIDS_ALGORITHM_CUSTOM &&
+         algorithm->config.custom.save != NULL;
+}
+
+embedids_result_t embedids_snapshot_size(const embedids_context_t *context,
+                                         size_t *size) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (size == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  size_t total = sizeof(snapshot_header_t);
+  for (uint32_t i = 0; i < snapshot_metric_count(context); i++) {
+    const embedids_metric_config_t *config = &context->system_config->metrics[i];
+    total += sizeof(snapshot_metric_t) +
+             (size_t)history_points(&config->metric) *
+                 sizeof(embedids_metric_datapoint_t);
+
+    uint32_t count = 0;
+    const embedids_algorithm_t *algorithms = embedids_metric_algorithms(config, &count);
+    for (uint32_t a = 0; a < count; a++) {
+      const embedids_algorithm_t *algorithm = &algorithms[a];
+      if (has_saved_state(algorithm)) {
+        total += sizeof(snapshot_state_t) +
+                 algorithm->config.custom.save(embedids_custom_context(config, algorithm),
+                                               NULL, 0);
+      }
+    }
+  }
+
+  if (total > UINT32_MAX) {
+    return EMBEDIDS_ERROR_OUT_OF_MEMORY;
+  }
+
+  *size = total;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_snapshot(const embedids_context_t *context,
+                                    void *buffer, size_t buffer_size) {
+  size_t required = 0;
+  embedids_result_t result = embedids_snapshot_size(context, &required);
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  if (buffer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (buffer_size < required) {
+    return EMBEDIDS_ERROR_BUFFER_FULL;
+  }
+
+  uint8_t *base = (uint8_t *)buffer;
+  uint8_t *p = base + sizeof(snapshot_header_t);
+  uint8_t *end = base + required;
+
+  for (uint32_t i = 0; i < snapshot_metric_count(context); i++) {
+    const embedids_metric_config_t *config = &context->system_config->metrics[i];
+    const embedids_metric_t *metric = &config->metric;
+
+    snapshot_metric_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, metric->name, sizeof(entry.name));
+    entry.type = (uint32_t)metric->type;
+    entry.max_history_size = metric->max_history_size;
+    entry.history_points = history_points(metric);
+    entry.current_size = metric->current_size;
+    entry.write_index = metric->write_index;
+    entry.unacked = metric->unacked;
+    uint32_t count = 0;
+    const embedids_algorithm_t *algorithms = embedids_metric_algorithms(config, &count);
+    for (uint32_t a = 0; a < count; a++) {
+      entry.num_states += has_saved_state(&algorithms[a]) ? 1 : 0;
+    }
+    memcpy(p, &entry, sizeof(entry));
+    p += sizeof(entry);
+
+    size_t ring_bytes =
+        (size_t)entry.history_points * sizeof(embedids_metric_datapoint_t);
+    if (ring_bytes > 0) {
+      memcpy(p, metric->history, ring_bytes);
+      p += ring_bytes;
+    }
+
+    for (uint32_t a = 0; a < count; a++) {
+      const embedids_algorithm_t *algorithm = &algorithms[a];
+      if (!has_saved_state(algorithm)) {
+        continue;
+      }
+
+      // The size may only be trusted once; re-query and check it still fits
+      void *state_context = embedids_custom_context(config, algorithm);
+      size_t state_size = algorithm->config.custom.save(state_context, NULL, 0);
+      if ((size_t)(end - p) < sizeof(snapshot_state_t) ||
+          state_size > (size_t)(end - p) - sizeof(snapshot_state_t)) {
+        return EMBEDIDS_ERROR_BUFFER_FULL;
+      }
+
+      snapshot_state_t state = {a, (uint32_t)state_size};
+      memcpy(p, &state, sizeof(state));
+      p += sizeof(state);
+      if (algorithm->config.custom.save(state_context, p,
+                                        state_size) != state_size) {
+        return EMBEDIDS_ERROR_ALGORITHM_FAILED;
+      }
+      p += state_size;
+    }
+  }
+
+  snapshot_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  header.name_len = EMBEDIDS_MAX_METRIC_NAME_LEN;
+  header.total_size = (uint32_t)(p - base);
+  header.num_metrics = snapshot_metric_count(context);
+  header.datapoint_size = sizeof(embedids_metric_datapoint_t);
+  header.crc = embedids_crc32c(0, base + sizeof(header),
+                               (size_t)(p - base) - sizeof(header));
+  memcpy(base, &header, sizeof(header));
+
+  return EMBEDIDS_OK;
+}
+
+/* Restore passes, run in order; each starts only if the previous succeeded */
+typedef enum {
+  RESTORE_CHECK, /* structure and compatibility only */
+  RESTORE_LOAD,  /* custom load hooks, which may fail */
+  RESTORE_APPLY  /* rings, which cannot fail */
+} restore_pass_t;
+
+/* Walk the snapshot entries, doing the work of one pass */
+static embedids_result_t restore_walk(embedids_context_t *context,
+                                      const uint8_t *p, const uint8_t *end,
+                                      uint32_t num_metrics, restore_pass_t pass) {
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    snapshot_metric_t entry;
+    if ((size_t)(end - p) < sizeof(entry)) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    memcpy(&entry, p, sizeof(entry));
+    p += sizeof(entry);
+
+    size_t ring_bytes =
+        (size_t)entry.history_points * sizeof(embedids_metric_datapoint_t);
+    if ((size_t)(end - p) < ring_bytes) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+    const uint8_t *ring = p;
+    p += ring_bytes;
+
+    embedids_metric_config_t *config =
+        embedids_find_metric_config(context, entry.name);
+    if (config != NULL && pass == RESTORE_CHECK) {
+      const embedids_metric_t *metric = &config->metric;
+      if (entry.type != (uint32_t)metric->type ||
+          entry.max_history_size != metric->max_history_size ||
+          entry.history_points != history_points(metric)) {
+        return EMBEDIDS_ERROR_CONFIG_INVALID;
+      }
+      if (entry.current_size > entry.history_points ||
+          (entry.history_points > 0 &&
+           entry.write_index >= entry.history_points) ||
+          entry.unacked > entry.current_size) {
+        return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+      }
+    }
+
+    if (config != NULL && pass == RESTORE_APPLY) {
+      embedids_metric_t *metric = &config->metric;
+      if (ring_bytes > 0) {
+        memcpy(metric->history, ring, ring_bytes);
+      }
+      metric->current_size = entry.current_size;
+      metric->write_index = entry.write_index;
+      metric->unacked = metric->backpressure ? entry.unacked : 0;
+      embedids_integrity_seal(metric);
+      embedids_range_build(metric);
+      embedids_stream_restart(config, true);
+      embedids_alert_clear(config);
+    }
+
+    for (uint32_t s = 0; s < entry.num_states; s++) {
+      snapshot_state_t state;
+      if ((size_t)(end - p) < sizeof(state)) {
+        return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+      }
+      memcpy(&state, p, sizeof(state));
+      p += sizeof(state);
+      if ((size_t)(end - p) < state.size) {
+        return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+      }
+
+      uint32_t count = 0;
+      const embedids_algorithm_t *algorithms =
+          config != NULL ? embedids_metric_algorithms(config, &count) : NULL;
+      if (pass == RESTORE_LOAD && state.algorithm_index < count) {
+        const embedids_algorithm_t *algorithm = &algorithms[state.algorithm_index];
+        if (algorithm->type == EMBEDIDS_ALGORITHM_CUSTOM &&
+            algorithm->config.custom.load != NULL) {
+          embedids_result_t result = algorithm->config.custom.load(
+              embedids_custom_context(config, algorithm), p, state.size);
+          if (result != EMBEDIDS_OK) {
+            return result;
+          }
+        }
+      }
+      p += state.size;
+    }
+  }
+
+  return p == end ? EMBEDIDS_OK : EMBEDIDS_ERROR_BUFFER_CORRUPT;
+}
+
+embedids_result_t embedids_restore(embedids_context_t *context,
+                                   const void *buffer, size_t buffer_size) {
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (buffer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  snapshot_header_t header;
+  if (buffer_size < sizeof(header)) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+  memcpy(&header, buffer, sizeof(header));
+
+  if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+      header.name_len != EMBEDIDS_MAX_METRIC_NAME_LEN ||
+      header.datapoint_size != sizeof(embedids_metric_datapoint_t) ||
+      header.total_size < sizeof(header) || header.total_size > buffer_size) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  const uint8_t *body = (const uint8_t *)buffer + sizeof(header);
+  const uint8_t *end = (const uint8_t *)buffer + header.total_size;
+  if (embedids_crc32c(0, body, (size_t)(end - body)) != header.crc) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  // Hooks run before any ring changes, so a failing one leaves every
+  // history as it was
+  embedids_result_t result =
+      restore_walk(context, body, end, header.num_metrics, RESTORE_CHECK);
+  if (result == EMBEDIDS_OK) {
+    result = restore_walk(context, body, end, header.num_metrics, RESTORE_LOAD);
+  }
+  if (result != EMBEDIDS_OK) {
+    return result;
+  }
+
+  context->epoch++;
+  return restore_walk(context, body, end, header.num_metrics, RESTORE_APPLY);
+}
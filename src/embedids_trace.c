@@ -0,0 +1,462 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "embedids.h"
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * File layout:
+ *
+ *   trace_header_t
+ *   embedids_trace_metric_entry_t[num_metrics]
+ *   padding up to header_size (multiple of TRACE_ALIGNMENT)
+ *   embedids_trace_record_t[record_count]
+ *   embedids_trace_index_entry_t[index_count]    (closed captures only)
+ *   trace_footer_t                               (closed captures only)
+ */
+
+#define TRACE_MAGIC 0x54444945u  /* "EIDT" */
+#define FOOTER_MAGIC 0x46444945u /* "EIDF" */
+#define TRACE_VERSION 1u
+#define TRACE_BYTE_ORDER 0x01020304u
+#define TRACE_ALIGNMENT 64u
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint32_t header_size;
+  uint32_t num_metrics;
+  uint32_t name_len;
+  uint32_t byte_order;
+} trace_header_t;
+
+typedef struct {
+  uint64_t record_count;
+  uint64_t index_offset;
+  uint32_t index_count;
+  uint32_t index_stride;
+  uint32_t magic;
+  uint32_t reserved;
+} trace_footer_t;
+
+_Static_assert(sizeof(embedids_trace_record_t) == 24,
+               "trace records must stay 24 bytes");
+_Static_assert(sizeof(trace_footer_t) == 32, "trace footer must stay 32 bytes");
+
+/* 64-bit so a corrupt num_metrics read from a file cannot wrap */
+static uint64_t trace_header_size(uint64_t num_metrics) {
+  uint64_t size = sizeof(trace_header_t) +
+                  num_metrics * sizeof(embedids_trace_metric_entry_t);
+  return (size + TRACE_ALIGNMENT - 1) & ~(uint64_t)(TRACE_ALIGNMENT - 1);
+}
+
+/* write(2) until everything is out, retrying on EINTR */
+static embedids_result_t write_all(int fd, const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return EMBEDIDS_ERROR_IO;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return EMBEDIDS_OK;
+}
+
+/* Copy into the coalescing buffer, writing it out whenever it fills */
+static embedids_result_t writer_put(embedids_trace_writer_t *writer,
+                                    const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+  while (len > 0) {
+    size_t room = EMBEDIDS_TRACE_BUFFER_SIZE - writer->buffer_used;
+    size_t chunk = len < room ? len : room;
+    memcpy(writer->buffer + writer->buffer_used, p, chunk);
+    writer->buffer_used += (uint32_t)chunk;
+    p += chunk;
+    len -= chunk;
+
+    if (writer->buffer_used == EMBEDIDS_TRACE_BUFFER_SIZE) {
+      embedids_result_t result = embedids_trace_writer_flush(writer);
+      if (result != EMBEDIDS_OK) {
+        return result;
+      }
+    }
+  }
+  return EMBEDIDS_OK;
+}
+
+static void writer_index(embedids_trace_writer_t *writer,
+                         uint64_t timestamp_ms) {
+  if (writer->index == NULL || writer->index_capacity == 0 ||
+      writer->record_count % writer->index_stride != 0) {
+    return;
+  }
+
+  if (writer->index_count == writer->index_capacity) {
+    // Keep every other entry and double the stride
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < writer->index_count; i += 2) {
+      writer->index[kept++] = writer->index[i];
+    }
+    writer->index_count = kept;
+    writer->index_stride *= 2;
+    if (writer->record_count % writer->index_stride != 0) {
+      return;
+    }
+  }
+
+  writer->index[writer->index_count].timestamp_ms = timestamp_ms;
+  writer->index[writer->index_count].record = writer->record_count;
+  writer->index_count++;
+}
+
+embedids_result_t embedids_trace_writer_open(embedids_trace_writer_t *writer,
+                                             int fd,
+                                             const embedids_context_t *context,
+                                             embedids_trace_index_entry_t *index,
+                                             uint32_t index_capacity) {
+  if (writer == NULL || fd < 0) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  const embedids_system_config_t *system = context->system_config;
+  uint32_t num_metrics = system->metrics ? system->num_active_metrics : 0;
+  if (num_metrics > EMBEDIDS_MAX_METRICS) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  memset(writer, 0, offsetof(embedids_trace_writer_t, buffer));
+  writer->fd = fd;
+  writer->status = EMBEDIDS_OK;
+  writer->num_metrics = num_metrics;
+  writer->index = index;
+  writer->index_capacity = index ? index_capacity : 0;
+  writer->index_stride = EMBEDIDS_TRACE_INDEX_STRIDE;
+
+  trace_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = TRACE_MAGIC;
+  header.version = TRACE_VERSION;
+  header.record_size = sizeof(embedids_trace_record_t);
+  header.header_size = (uint32_t)trace_header_size(num_metrics);
+  header.num_metrics = num_metrics;
+  header.name_len = EMBEDIDS_MAX_METRIC_NAME_LEN;
+  header.byte_order = TRACE_BYTE_ORDER;
+
+  embedids_result_t result = writer_put(writer, &header, sizeof(header));
+  for (uint32_t i = 0; i < num_metrics && result == EMBEDIDS_OK; i++) {
+    embedids_trace_metric_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, system->metrics[i].metric.name, sizeof(entry.name));
+    entry.type = (uint32_t)system->metrics[i].metric.type;
+    result = writer_put(writer, &entry, sizeof(entry));
+  }
+
+  static const uint8_t padding[TRACE_ALIGNMENT];
+  size_t written = sizeof(header) +
+                  (size_t)num_metrics * sizeof(embedids_trace_metric_entry_t);
+  if (result == EMBEDIDS_OK) {
+    result = writer_put(writer, padding, header.header_size - written);
+  }
+
+  writer->status = result;
+  return result;
+}
+
+embedids_result_t
+embedids_trace_writer_append(embedids_trace_writer_t *writer,
+                             uint32_t metric_index,
+                             const embedids_metric_datapoint_t *datapoint) {
+  if (writer == NULL || datapoint == NULL ||
+      metric_index >= writer->num_metrics) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (writer->status != EMBEDIDS_OK) {
+    return writer->status;
+  }
+
+  embedids_trace_record_t record;
+  record.timestamp_ms = datapoint->timestamp_ms;
+  record.value = datapoint->value;
+  record.metric_index = (uint16_t)metric_index;
+  record.flags = datapoint->flags;
+  record.reserved = 0;
+
+  writer_index(writer, record.timestamp_ms);
+
+  embedids_result_t result = writer_put(writer, &record, sizeof(record));
+  if (result != EMBEDIDS_OK) {
+    writer->status = result;
+    return result;
+  }
+
+  writer->record_count++;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_trace_writer_flush(embedids_trace_writer_t *writer) {
+  if (writer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (writer->buffer_used == 0) {
+    return writer->status;
+  }
+
+  embedids_result_t result =
+      write_all(writer->fd, writer->buffer, writer->buffer_used);
+  writer->buffer_used = 0;
+  if (result != EMBEDIDS_OK && writer->status == EMBEDIDS_OK) {
+    writer->status = result;
+  }
+  return writer->status;
+}
+
+embedids_result_t embedids_trace_writer_close(embedids_trace_writer_t *writer) {
+  if (writer == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (writer->status != EMBEDIDS_OK) {
+    return writer->status;
+  }
+
+  trace_footer_t footer;
+  memset(&footer, 0, sizeof(footer));
+  footer.record_count = writer->record_count;
+  footer.index_offset = trace_header_size(writer->num_metrics) +
+                        writer->record_count * sizeof(embedids_trace_record_t);
+  footer.index_count = writer->index_count;
+  footer.index_stride = writer->index_stride;
+  footer.magic = FOOTER_MAGIC;
+
+  embedids_result_t result = writer_put(
+      writer, writer->index,
+      (size_t)writer->index_count * sizeof(embedids_trace_index_entry_t));
+  if (result == EMBEDIDS_OK) {
+    result = writer_put(writer, &footer, sizeof(footer));
+  }
+  if (result == EMBEDIDS_OK) {
+    result = embedids_trace_writer_flush(writer);
+  }
+
+  writer->status = result;
+  return result;
+}
+
+static void trace_hook(uint32_t metric_index,
+                       const embedids_metric_datapoint_t *datapoint,
+                       void *user_data) {
+  // Failures are sticky in writer->status and reported on close
+  (void)embedids_trace_writer_append((embedids_trace_writer_t *)user_data,
+                                     metric_index, datapoint);
+}
+
+embedids_result_t embedids_trace_attach(embedids_context_t *context,
+                                        embedids_trace_writer_t *writer) {
+  if (writer && context && context->initialized &&
+      context->system_config->num_active_metrics > writer->num_metrics) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+
+  embedids_result_t result = embedids_set_datapoint_hook(
+      context, writer ? trace_hook : NULL, writer);
+  if (result == EMBEDIDS_OK) {
+    // Records carry slot indexes into the table written at open
+    context->slots_pinned = writer != NULL;
+  }
+  return result;
+}
+
+embedids_result_t embedids_trace_reader_open(embedids_trace_reader_t *reader,
+                                             int fd) {
+  if (reader == NULL || fd < 0) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  memset(reader, 0, sizeof(*reader));
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return EMBEDIDS_ERROR_IO;
+  }
+  if ((uint64_t)st.st_size < sizeof(trace_header_t)) {
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (base == MAP_FAILED) {
+    return EMBEDIDS_ERROR_IO;
+  }
+
+  const uint8_t *bytes = (const uint8_t *)base;
+  const trace_header_t *header = (const trace_header_t *)base;
+  if (header->magic != TRACE_MAGIC || header->version != TRACE_VERSION ||
+      header->byte_order != TRACE_BYTE_ORDER ||
+      header->record_size != sizeof(embedids_trace_record_t) ||
+      header->name_len != EMBEDIDS_MAX_METRIC_NAME_LEN ||
+      header->num_metrics > EMBEDIDS_MAX_METRICS ||
+      header->header_size != trace_header_size(header->num_metrics) ||
+      header->header_size > size) {
+    munmap(base, size);
+    return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+  }
+
+  reader->base = base;
+  reader->size = size;
+  reader->metrics =
+      (const embedids_trace_metric_entry_t *)(bytes + sizeof(trace_header_t));
+  reader->num_metrics = header->num_metrics;
+  reader->records =
+      (const embedids_trace_record_t *)(bytes + header->header_size);
+
+  // A valid footer must account for every byte between header and footer;
+  // the count is bounded first so the products below cannot wrap
+  uint64_t body = size - header->header_size;
+  if (body >= sizeof(trace_footer_t)) {
+    const trace_footer_t *footer =
+        (const trace_footer_t *)(bytes + size - sizeof(trace_footer_t));
+    if (footer->magic == FOOTER_MAGIC &&
+        footer->record_count <= body / sizeof(embedids_trace_record_t)) {
+      uint64_t records_end = header->header_size +
+                             footer->record_count * sizeof(embedids_trace_record_t);
+      if (footer->index_offset == records_end &&
+          records_end + (uint64_t)footer->index_count *
+                            sizeof(embedids_trace_index_entry_t) +
+                  sizeof(trace_footer_t) == size) {
+        reader->record_count = footer->record_count;
+        reader->index = (const embedids_trace_index_entry_t *)(bytes + records_end);
+        reader->index_count = footer->index_count;
+        reader->complete = true;
+      }
+    }
+  }
+
+  // Seeking uses index entries as record bounds, so they must be in range
+  // and in order
+  for (uint32_t i = 0; i < reader->index_count; i++) {
+    if (reader->index[i].record > reader->record_count ||
+        (i > 0 && reader->index[i].record < reader->index[i - 1].record)) {
+      munmap(base, size);
+      memset(reader, 0, sizeof(*reader));
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+  }
+
+  if (!reader->complete) {
+    reader->record_count = body / sizeof(embedids_trace_record_t);
+  }
+
+  (void)posix_madvise(base, size, POSIX_MADV_SEQUENTIAL);
+  return EMBEDIDS_OK;
+}
+
+void embedids_trace_reader_close(embedids_trace_reader_t *reader) {
+  if (reader && reader->base) {
+    munmap((void *)reader->base, (size_t)reader->size);
+    memset(reader, 0, sizeof(*reader));
+  }
+}
+
+embedids_result_t embedids_trace_reader_seek(const embedids_trace_reader_t *reader,
+                                             uint64_t timestamp_ms,
+                                             uint64_t *position) {
+  if (reader == NULL || reader->base == NULL || position == NULL) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  uint64_t lo = 0;
+  uint64_t hi = reader->record_count;
+
+  // Narrow the search to one indexed run before touching the records
+  if (reader->index_count > 0) {
+    uint32_t left = 0;
+    uint32_t right = reader->index_count;
+    while (left < right) {
+      uint32_t mid = left + (right - left) / 2;
+      if (reader->index[mid].timestamp_ms < timestamp_ms) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    if (left > 0) {
+      lo = reader->index[left - 1].record;
+    }
+    if (left < reader->index_count) {
+      hi = reader->index[left].record;
+    }
+  }
+
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (reader->records[mid].timestamp_ms < timestamp_ms) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  *position = lo;
+  return EMBEDIDS_OK;
+}
+
+embedids_result_t embedids_trace_replay(const embedids_trace_reader_t *reader,
+                                        embedids_context_t *context,
+                                        uint64_t first, uint64_t count) {
+  if (reader == NULL || reader->base == NULL || first > reader->record_count ||
+      count > reader->record_count - first) {
+    return EMBEDIDS_ERROR_INVALID_PARAM;
+  }
+
+  if (!context || !context->initialized) {
+    return EMBEDIDS_ERROR_NOT_INITIALIZED;
+  }
+
+  for (uint64_t i = first; i < first + count; i++) {
+    const embedids_trace_record_t *record = &reader->records[i];
+    if (record->metric_index >= reader->num_metrics) {
+      return EMBEDIDS_ERROR_BUFFER_CORRUPT;
+    }
+
+    embedids_result_t result = embedids_add_datapoint(
+        context, reader->metrics[record->metric_index].name, record->value,
+        record->timestamp_ms);
+    if (result != EMBEDIDS_OK) {
+      return result;
+    }
+  }
+
+  return EMBEDIDS_OK;
+}
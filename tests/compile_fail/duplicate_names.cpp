@@ -0,0 +1,7 @@
+// Must not compile: two metrics with the same name
+#include "embedids.hpp"
+
+constexpr auto first = embedids::metric("cpu_usage", EMBEDIDS_METRIC_TYPE_FLOAT, 8);
+constexpr auto second = embedids::metric("cpu_usage", EMBEDIDS_METRIC_TYPE_FLOAT, 8);
+
+int main() { return embedids::Config<first, second>::num_metrics; }
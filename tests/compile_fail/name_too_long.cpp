@@ -0,0 +1,8 @@
+// Must not compile: the name does not fit EMBEDIDS_MAX_METRIC_NAME_LEN
+#include "embedids.hpp"
+
+constexpr auto metric = embedids::metric(
+    "this_metric_name_is_much_longer_than_the_configured_limit_allows",
+    EMBEDIDS_METRIC_TYPE_UINT32, 8);
+
+int main() { return embedids::Config<metric>::num_metrics; }
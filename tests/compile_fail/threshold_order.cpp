@@ -0,0 +1,7 @@
+// Must not compile: negative integer bounds in the wrong order on a float metric
+#include "embedids.hpp"
+
+constexpr auto metric = embedids::metric("temperature", EMBEDIDS_METRIC_TYPE_FLOAT, 8)
+                            .with(embedids::threshold().min(-5).max(-10));
+
+int main() { return embedids::Config<metric>::num_metrics; }
@@ -0,0 +1,7 @@
+// Must not compile: a floating point bound on an integer metric
+#include "embedids.hpp"
+
+constexpr auto metric = embedids::metric("open_files", EMBEDIDS_METRIC_TYPE_UINT32, 8)
+                            .with(embedids::threshold().max(99.5));
+
+int main() { return embedids::Config<metric>::num_metrics; }
@@ -0,0 +1,11 @@
+// Must not compile: more algorithms than EMBEDIDS_MAX_ALGORITHMS_PER_METRIC
+#include "embedids.hpp"
+
+constexpr auto metric = embedids::metric("open_files", EMBEDIDS_METRIC_TYPE_UINT32, 8)
+                            .with(embedids::threshold().max(10u))
+                            .with(embedids::threshold().max(20u))
+                            .with(embedids::threshold().max(30u))
+                            .with(embedids::threshold().max(40u))
+                            .with(embedids::threshold().max(50u));
+
+int main() { return embedids::Config<metric>::num_metrics; }
@@ -0,0 +1,22 @@
+/*
+ * C11 callers of embedids_add(), which only exists in C. Called from
+ * test_ingest.cpp.
+ */
+#include "embedids.h"
+
+embedids_result_t ingest_generic_u32(const embedids_u32_handle_t *handle, uint32_t value,
+                                     uint64_t timestamp_ms) {
+  return embedids_add(handle, value, timestamp_ms);
+}
+
+embedids_result_t ingest_generic_bool(embedids_bool_handle_t *handle, bool value,
+                                      uint64_t timestamp_ms) {
+  return embedids_add(handle, value, timestamp_ms);
+}
+
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+embedids_result_t ingest_generic_f32(const embedids_f32_handle_t *handle, float value,
+                                     uint64_t timestamp_ms) {
+  return embedids_add(handle, value, timestamp_ms);
+}
+#endif
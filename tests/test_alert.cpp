@@ -0,0 +1,226 @@
+#include "embedids.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for alert debouncing
+ *
+ * Tests that alert rules raise after consecutive hits, hold across a
+ * hysteresis band, clear and re-arm after misses and keep reports apart
+ * by their cooldown, while algorithms without a rule report as before.
+ */
+class EmbedIDSAlertTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history[8];
+  embedids_alert_rule_t rule;
+  embedids_alert_state_t alerts[2];
+  uint64_t now_ms = 0;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(&metric_config, 0, sizeof(metric_config));
+    memset(history, 0, sizeof(history));
+    memset(&rule, 0, sizeof(rule));
+    memset(alerts, 0, sizeof(alerts));
+
+    strncpy(metric_config.metric.name, "temperature", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_config.metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_config.metric.history = history;
+    metric_config.metric.max_history_size = 8;
+    metric_config.metric.enabled = true;
+    metric_config.num_algorithms = 1;
+    metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    metric_config.algorithms[0].enabled = true;
+    metric_config.algorithms[0].config.threshold.max_threshold.u32 = 100;
+    metric_config.algorithms[0].config.threshold.check_max = true;
+    metric_config.alerts = alerts;
+    alerts[0].rule = &rule;
+
+    system_config.metrics = &metric_config;
+    system_config.max_metrics = 1;
+    system_config.num_active_metrics = 1;
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  void init() { ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK); }
+
+  // Add one point 100 ms after the previous one and analyze
+  embedids_result_t step(uint32_t value) {
+    embedids_metric_value_t v;
+    v.u32 = value;
+    now_ms += 100;
+    EXPECT_EQ(embedids_add_datapoint(&context, "temperature", v, now_ms), EMBEDIDS_OK);
+    return embedids_analyze_metric(&context, "temperature");
+  }
+};
+
+// ============================================================================
+// Debounce and Hysteresis Tests
+// ============================================================================
+
+TEST_F(EmbedIDSAlertTest, ConsecutiveHitsRaise) {
+  rule.raise_after = 3;
+  init();
+
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(50), EMBEDIDS_OK); // A miss before raising starts over
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  // Raised without report_once, every further hit reports
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(alerts[0].reports, 2u);
+  EXPECT_TRUE(alerts[0].raised);
+}
+
+TEST_F(EmbedIDSAlertTest, ReportOnceRearmsAfterClear) {
+  rule.report_once = true;
+  rule.clear_after = 2;
+  init();
+
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(50), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_OK); // One miss is not enough to clear
+  EXPECT_EQ(step(50), EMBEDIDS_OK);
+  EXPECT_EQ(step(50), EMBEDIDS_OK);
+  EXPECT_FALSE(alerts[0].raised);
+
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(alerts[0].reports, 2u);
+}
+
+TEST_F(EmbedIDSAlertTest, ScoreBandsHoldTheAlert) {
+  // Raise at 200 or more, stay raised down to 120
+  rule.raise_score = 1.0f;
+  rule.clear_score = 0.2f;
+  init();
+
+  EXPECT_EQ(step(150), EMBEDIDS_OK); // Over the bound but under the raise band
+  EXPECT_FALSE(alerts[0].raised);
+  EXPECT_EQ(step(250), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(step(110), EMBEDIDS_OK);
+  EXPECT_FALSE(alerts[0].raised);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSAlertTest, CooldownUsesPointTimestamps) {
+  rule.cooldown_ms = 300;
+  init();
+
+  embedids_detection_t detection;
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(alerts[0].last_report_ms, 400u);
+
+  // Analyzing again without new points repeats the report without counting it
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "temperature", &detection),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(detection.timestamp_ms, 400u);
+  EXPECT_EQ(alerts[0].reports, 2u);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "temperature"), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSAlertTest, RepeatedAnalysisCountsOnce) {
+  rule.raise_after = 2;
+  init();
+
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "temperature"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+  EXPECT_EQ(alerts[0].hits, 1u);
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+
+// ============================================================================
+// Integration Tests
+// ============================================================================
+
+TEST_F(EmbedIDSAlertTest, DetailedReportDescribesTheHit) {
+  rule.raise_after = 2;
+  init();
+
+  embedids_metric_value_t v;
+  v.u32 = 150;
+  embedids_detection_t detection;
+  ASSERT_EQ(embedids_add_datapoint(&context, "temperature", v, 10), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "temperature", &detection), EMBEDIDS_OK);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_NONE);
+
+  v.u32 = 300;
+  ASSERT_EQ(embedids_add_datapoint(&context, "temperature", v, 20), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "temperature", &detection),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(detection.algorithm, 0u);
+  EXPECT_EQ(detection.timestamp_ms, 20u);
+  EXPECT_FLOAT_EQ(detection.score, 2.0f);
+}
+
+TEST_F(EmbedIDSAlertTest, RulelessAlgorithmsStillReport) {
+  rule.raise_after = 5;
+  metric_config.num_algorithms = 2;
+  metric_config.algorithms[1] = metric_config.algorithms[0];
+  metric_config.algorithms[1].config.threshold.max_threshold.u32 = 200;
+  init();
+
+  // The debounced algorithm holds back, the second reports at once
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(250), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(alerts[0].hits, 2u);
+}
+
+TEST_F(EmbedIDSAlertTest, EnsembleVotesOnlyReportedAlerts) {
+  embedids_ensemble_t ensemble;
+  memset(&ensemble, 0, sizeof(ensemble));
+  ensemble.policy = EMBEDIDS_ENSEMBLE_ALL;
+  rule.raise_after = 2;
+  metric_config.num_algorithms = 2;
+  metric_config.algorithms[1] = metric_config.algorithms[0];
+  metric_config.ensemble = &ensemble;
+  init();
+
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+
+TEST_F(EmbedIDSAlertTest, ResetAndInitClearState) {
+  rule.raise_after = 2;
+  init();
+
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+  EXPECT_EQ(step(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_FALSE(alerts[0].raised);
+  EXPECT_EQ(alerts[0].reports, 0u);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+
+  // Stale state left by a previous run is discarded at init
+  embedids_cleanup(&context);
+  alerts[0].raised = true;
+  alerts[0].hits = 7;
+  init();
+  EXPECT_EQ(alerts[0].rule, &rule);
+  EXPECT_EQ(step(150), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSAlertTest, PortableFormatsRejectAlerts) {
+  size_t size = 0;
+  EXPECT_EQ(embedids_config_to_blob(&metric_config, 1, nullptr, 0, &size),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+
+  embedids_fleet_memory_t report;
+  EXPECT_EQ(embedids_fleet_memory(&metric_config, 1, 4, &report),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+}
@@ -1,4 +1,5 @@
 #include "embedids.h"
+#include <cmath>
 #include <cstring>
 #include <gtest/gtest.h>
 
@@ -453,3 +454,369 @@ TEST_F(EmbedIDSAnalysisTest, SequentialAnalysisCalls) {
   EXPECT_EQ(embedids_add_datapoint(&context, "test_metric", value, 2000), EMBEDIDS_OK);
   EXPECT_EQ(embedids_analyze_metric(&context, "test_metric"), EMBEDIDS_OK);
 }
+
+// ============================================================================
+// Stepwise Analysis Tests
+// ============================================================================
+
+TEST_F(EmbedIDSAnalysisTest, AnalyzeNextVisitsEnabledMetrics) {
+  embedids_metric_datapoint_t history_buffers[3][4];
+  embedids_metric_config_t metric_configs[3];
+  setupBasicMetric(metric_configs[0], history_buffers[0], "first",
+                   EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  setupBasicMetric(metric_configs[1], history_buffers[1], "skipped",
+                   EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  setupBasicMetric(metric_configs[2], history_buffers[2], "last",
+                   EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  metric_configs[1].metric.enabled = false;
+  metric_configs[2].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  metric_configs[2].algorithms[0].enabled = true;
+  metric_configs[2].algorithms[0].config.threshold.max_threshold.u32 = 10;
+  metric_configs[2].algorithms[0].config.threshold.check_max = true;
+  metric_configs[2].num_algorithms = 1;
+
+  embedids_system_config_t system_config;
+  memset(&system_config, 0, sizeof(system_config));
+  system_config.metrics = metric_configs;
+  system_config.max_metrics = 3;
+  system_config.num_active_metrics = 3;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 20;
+  ASSERT_EQ(embedids_add_datapoint(&context, "last", value, 1000), EMBEDIDS_OK);
+
+  uint32_t cursor = 0;
+  uint32_t slot = 99;
+  EXPECT_EQ(embedids_analyze_next(&context, &cursor, &slot), EMBEDIDS_OK);
+  EXPECT_EQ(slot, 0u);
+  EXPECT_EQ(embedids_analyze_next(&context, &cursor, &slot),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(slot, 2u);
+  EXPECT_EQ(embedids_analyze_next(&context, &cursor, &slot),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  EXPECT_EQ(embedids_analyze_next(&context, nullptr, &slot), EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+// ============================================================================
+// Detection Detail Tests
+// ============================================================================
+
+TEST_F(EmbedIDSAnalysisTest, ThresholdDetectionScoresExcess) {
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "cpu", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  metric_config.algorithms[0].enabled = true;
+  metric_config.algorithms[0].config.threshold.min_threshold.u32 = 50;
+  metric_config.algorithms[0].config.threshold.max_threshold.u32 = 100;
+  metric_config.algorithms[0].config.threshold.check_min = true;
+  metric_config.algorithms[0].config.threshold.check_max = true;
+  metric_config.num_algorithms = 1;
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  embedids_detection_t detection;
+  embedids_metric_value_t value;
+  value.u32 = 70;
+  ASSERT_EQ(embedids_add_datapoint(&context, "cpu", value, 1000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "cpu", &detection), EMBEDIDS_OK);
+  EXPECT_EQ(detection.result, EMBEDIDS_OK);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_NONE);
+  EXPECT_EQ(detection.score, 0.0f);
+  EXPECT_EQ(detection.metric, 0u);
+  EXPECT_EQ(detection.point, EMBEDIDS_NO_INDEX);
+
+  // Three times the maximum is twice the bound in excess
+  value.u32 = 300;
+  ASSERT_EQ(embedids_add_datapoint(&context, "cpu", value, 2000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "cpu", &detection),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(detection.result, EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_FLOAT_EQ(detection.score, 2.0f);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_HIGH);
+  EXPECT_EQ(detection.algorithm, 0u);
+  EXPECT_EQ(detection.point, 1u);
+  EXPECT_EQ(detection.timestamp_ms, 2000u);
+
+  value.u32 = 40;
+  ASSERT_EQ(embedids_add_datapoint(&context, "cpu", value, 3000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "cpu", &detection),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_FLOAT_EQ(detection.score, 0.2f);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_LOW);
+  EXPECT_EQ(detection.point, 2u);
+
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "cpu", nullptr),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+TEST_F(EmbedIDSAnalysisTest, AnalyzeAllDetailedKeepsStrongest) {
+  const uint32_t values[4] = {110, 400, 50, 150};
+  const char *names[4] = {"a", "b", "c", "d"};
+  embedids_metric_datapoint_t history_buffers[4][4];
+  embedids_metric_config_t metric_configs[4];
+  for (int i = 0; i < 4; i++) {
+    setupBasicMetric(metric_configs[i], history_buffers[i], names[i],
+                     EMBEDIDS_METRIC_TYPE_UINT32, 4);
+    metric_configs[i].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    metric_configs[i].algorithms[0].enabled = true;
+    metric_configs[i].algorithms[0].config.threshold.max_threshold.u32 = 100;
+    metric_configs[i].algorithms[0].config.threshold.check_max = true;
+    metric_configs[i].num_algorithms = 1;
+  }
+
+  embedids_system_config_t system_config;
+  memset(&system_config, 0, sizeof(system_config));
+  system_config.metrics = metric_configs;
+  system_config.max_metrics = 4;
+  system_config.num_active_metrics = 4;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  for (int i = 0; i < 4; i++) {
+    embedids_metric_value_t value;
+    value.u32 = values[i];
+    ASSERT_EQ(embedids_add_datapoint(&context, names[i], value, 1000), EMBEDIDS_OK);
+  }
+
+  // Three metrics fire; the two strongest are kept, in slot order
+  embedids_detection_t detections[2];
+  uint32_t count = 0;
+  EXPECT_EQ(embedids_analyze_all_detailed(&context, detections, 2, &count),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(count, 3u);
+  EXPECT_EQ(detections[0].metric, 1u);
+  EXPECT_FLOAT_EQ(detections[0].score, 3.0f);
+  EXPECT_EQ(detections[1].metric, 3u);
+  EXPECT_FLOAT_EQ(detections[1].score, 0.5f);
+
+  // Counting alone needs no array
+  EXPECT_EQ(embedids_analyze_all_detailed(&context, nullptr, 0, &count),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(count, 3u);
+  EXPECT_EQ(embedids_analyze_all_detailed(&context, nullptr, 1, &count),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+TEST_F(EmbedIDSAnalysisTest, CustomDetailHookDescribesDetection) {
+  // Flags the first stored point above 10 and remembers where it was
+  auto detector = [](const embedids_metric_t *metric, const void *config,
+                     void *context) -> embedids_result_t {
+    (void)config;
+    embedids_datapoint_span_t span;
+    embedids_metric_window(metric, metric->current_size, &span);
+    for (uint32_t i = 0; i < EMBEDIDS_SPAN_COUNT(&span); i++) {
+      const embedids_metric_datapoint_t *point = EMBEDIDS_SPAN_AT(&span, i);
+      if (point->value.u32 > 10) {
+        *static_cast<uint32_t *>(context) = (uint32_t)(point - metric->history);
+        return EMBEDIDS_ERROR_STATISTICAL_ANOMALY;
+      }
+    }
+    return EMBEDIDS_OK;
+  };
+  auto detail = [](const embedids_metric_t *metric, const void *config, const void *state,
+                   embedids_detection_t *detection) {
+    (void)config;
+    detection->point = *static_cast<const uint32_t *>(state);
+    detection->timestamp_ms = metric->history[detection->point].timestamp_ms;
+    detection->score = 12.0f;
+  };
+
+  uint32_t offending = 0;
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "proc", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  metric_config.algorithms[0].enabled = true;
+  metric_config.algorithms[0].config.custom.function = detector;
+  metric_config.algorithms[0].config.custom.context = &offending;
+  metric_config.num_algorithms = 1;
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  const uint32_t values[3] = {5, 50, 7};
+  for (uint32_t i = 0; i < 3; i++) {
+    embedids_metric_value_t value;
+    value.u32 = values[i];
+    ASSERT_EQ(embedids_add_datapoint(&context, "proc", value, 1000 + i), EMBEDIDS_OK);
+  }
+
+  // Without a hook the newest point is blamed with a typical score
+  embedids_detection_t detection;
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "proc", &detection),
+            EMBEDIDS_ERROR_STATISTICAL_ANOMALY);
+  EXPECT_FLOAT_EQ(detection.score, 1.0f);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_MEDIUM);
+  EXPECT_EQ(detection.point, 2u);
+
+  metric_config.algorithms[0].config.custom.detail = detail;
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "proc", &detection),
+            EMBEDIDS_ERROR_STATISTICAL_ANOMALY);
+  EXPECT_FLOAT_EQ(detection.score, 12.0f);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_CRITICAL);
+  EXPECT_EQ(detection.point, 1u);
+  EXPECT_EQ(detection.timestamp_ms, 1001u);
+}
+
+TEST_F(EmbedIDSAnalysisTest, SeverityBands) {
+  EXPECT_EQ(embedids_severity_from_score(0.0f), EMBEDIDS_SEVERITY_NONE);
+  EXPECT_EQ(embedids_severity_from_score(-1.0f), EMBEDIDS_SEVERITY_NONE);
+  EXPECT_EQ(embedids_severity_from_score(0.49f), EMBEDIDS_SEVERITY_LOW);
+  EXPECT_EQ(embedids_severity_from_score(0.5f), EMBEDIDS_SEVERITY_MEDIUM);
+  EXPECT_EQ(embedids_severity_from_score(2.0f), EMBEDIDS_SEVERITY_HIGH);
+  EXPECT_EQ(embedids_severity_from_score(10.0f), EMBEDIDS_SEVERITY_CRITICAL);
+}
+
+// ============================================================================
+// Ensemble Tests
+// ============================================================================
+
+TEST_F(EmbedIDSAnalysisTest, EnsemblePoliciesVote) {
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "rx", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  const uint32_t bounds[3] = {100, 200, 300};
+  for (int i = 0; i < 3; i++) {
+    metric_config.algorithms[i].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    metric_config.algorithms[i].enabled = true;
+    metric_config.algorithms[i].config.threshold.max_threshold.u32 = bounds[i];
+    metric_config.algorithms[i].config.threshold.check_max = true;
+  }
+  metric_config.num_algorithms = 3;
+
+  const float weights[3] = {1.0f, 1.0f, 4.0f};
+  embedids_ensemble_t ensemble;
+  memset(&ensemble, 0, sizeof(ensemble));
+  metric_config.ensemble = &ensemble;
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  auto verdict = [&](uint32_t reading) {
+    embedids_metric_value_t value;
+    value.u32 = reading;
+    EXPECT_EQ(embedids_add_datapoint(&context, "rx", value, 1000), EMBEDIDS_OK);
+    return embedids_analyze_metric(&context, "rx");
+  };
+
+  // 150 trips one bound, 250 two and 350 all three
+  ensemble.policy = EMBEDIDS_ENSEMBLE_ANY;
+  EXPECT_EQ(verdict(50), EMBEDIDS_OK);
+  EXPECT_EQ(verdict(150), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  ensemble.policy = EMBEDIDS_ENSEMBLE_ALL;
+  EXPECT_EQ(verdict(250), EMBEDIDS_OK);
+  EXPECT_EQ(verdict(350), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  ensemble.policy = EMBEDIDS_ENSEMBLE_K_OF_N;
+  ensemble.k = 2;
+  EXPECT_EQ(verdict(150), EMBEDIDS_OK);
+  EXPECT_EQ(verdict(250), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  // Scores at 250 are 1.5 and 0.25; at 150 only 0.5
+  ensemble.policy = EMBEDIDS_ENSEMBLE_WEIGHTED;
+  ensemble.threshold = 1.0f;
+  ensemble.weights = weights;
+  EXPECT_EQ(verdict(150), EMBEDIDS_OK);
+  EXPECT_EQ(verdict(250), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  embedids_detection_t detection;
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "rx", &detection),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_FLOAT_EQ(detection.score, 1.75f);
+  EXPECT_EQ(detection.algorithm, 0u);
+
+  // All three fire and each score counts with its weight
+  EXPECT_EQ(verdict(330), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "rx", &detection),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_FLOAT_EQ(detection.score, 2.3f + 0.65f + 4.0f * 0.1f);
+}
+
+TEST_F(EmbedIDSAnalysisTest, EnsembleRunsEveryAlgorithm) {
+  // Always fires and counts its calls
+  auto firing = [](const embedids_metric_t *metric, const void *config,
+                   void *context) -> embedids_result_t {
+    (void)metric;
+    (void)config;
+    (*static_cast<uint32_t *>(context))++;
+    return EMBEDIDS_ERROR_STATISTICAL_ANOMALY;
+  };
+
+  uint32_t calls[2] = {0, 0};
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "proc", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  for (int i = 0; i < 2; i++) {
+    metric_config.algorithms[i].type = EMBEDIDS_ALGORITHM_CUSTOM;
+    metric_config.algorithms[i].enabled = true;
+    metric_config.algorithms[i].config.custom.function = firing;
+    metric_config.algorithms[i].config.custom.context = &calls[i];
+  }
+  metric_config.num_algorithms = 2;
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  // Without an ensemble the first detection ends the analysis
+  EXPECT_EQ(embedids_analyze_metric(&context, "proc"), EMBEDIDS_ERROR_STATISTICAL_ANOMALY);
+  EXPECT_EQ(calls[0], 1u);
+  EXPECT_EQ(calls[1], 0u);
+
+  embedids_ensemble_t ensemble;
+  memset(&ensemble, 0, sizeof(ensemble));
+  ensemble.policy = EMBEDIDS_ENSEMBLE_ALL;
+  metric_config.ensemble = &ensemble;
+  EXPECT_EQ(embedids_analyze_metric(&context, "proc"), EMBEDIDS_ERROR_STATISTICAL_ANOMALY);
+  EXPECT_EQ(calls[0], 2u);
+  EXPECT_EQ(calls[1], 1u);
+
+  // Disabled algorithms neither vote nor block a unanimous verdict
+  metric_config.algorithms[1].enabled = false;
+  EXPECT_EQ(embedids_analyze_metric(&context, "proc"), EMBEDIDS_ERROR_STATISTICAL_ANOMALY);
+  EXPECT_EQ(calls[1], 1u);
+}
+
+TEST_F(EmbedIDSAnalysisTest, EnsembleValidation) {
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "rx", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  metric_config.num_algorithms = 2;
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  metric_config.algorithms[1].type = EMBEDIDS_ALGORITHM_TREND;
+  embedids_ensemble_t ensemble;
+  memset(&ensemble, 0, sizeof(ensemble));
+  metric_config.ensemble = &ensemble;
+
+  embedids_system_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.metrics = &metric_config;
+  config.max_metrics = 1;
+  config.num_active_metrics = 1;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_OK);
+
+  ensemble.policy = EMBEDIDS_ENSEMBLE_K_OF_N;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  ensemble.k = 1;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_OK);
+  ensemble.k = 3; // More votes than algorithms can never pass
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  ensemble.policy = EMBEDIDS_ENSEMBLE_WEIGHTED;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  ensemble.threshold = 2.0f;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_OK);
+  ensemble.threshold = INFINITY;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  ensemble.threshold = 2.0f;
+
+  float weights[2] = {1.0f, -0.5f};
+  ensemble.weights = weights;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  weights[1] = NAN;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  weights[1] = INFINITY;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  weights[1] = 0.0f;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_OK);
+  ensemble.weights = nullptr;
+
+  // Ensembles are pointers and cannot be compiled into a blob
+  size_t blob_size = 0;
+  EXPECT_EQ(embedids_config_to_blob(&metric_config, 1, nullptr, 0, &blob_size),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+}
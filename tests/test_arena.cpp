@@ -0,0 +1,185 @@
+#include "embedids.h"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for the memory arena
+ *
+ * Tests that rings are carved cache-line aligned from one block, that a
+ * measuring arena reports the exact size, and that failures leave the
+ * configuration untouched.
+ */
+class EmbedIDSArenaTest : public ::testing::Test {
+protected:
+  alignas(EMBEDIDS_CACHE_LINE_SIZE) uint8_t block[4096];
+  embedids_metric_config_t metrics[3];
+
+  void SetUp() override {
+    memset(block, 0xAA, sizeof(block));
+    memset(metrics, 0, sizeof(metrics));
+    const char *names[3] = {"cpu", "memory", "sockets"};
+    const uint32_t sizes[3] = {10, 3, 40};
+    for (int i = 0; i < 3; i++) {
+      strncpy(metrics[i].metric.name, names[i], EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+      metrics[i].metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+      metrics[i].metric.max_history_size = sizes[i];
+      metrics[i].metric.enabled = true;
+    }
+  }
+};
+
+// ============================================================================
+// Allocation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSArenaTest, AllocationsAreCacheLineAligned) {
+  embedids_arena_t arena;
+  ASSERT_EQ(embedids_arena_init(&arena, block, sizeof(block)), EMBEDIDS_OK);
+
+  void *first = nullptr;
+  void *second = nullptr;
+  ASSERT_EQ(embedids_arena_alloc(&arena, 1, &first), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_arena_alloc(&arena, EMBEDIDS_CACHE_LINE_SIZE + 1, &second), EMBEDIDS_OK);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % EMBEDIDS_CACHE_LINE_SIZE, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % EMBEDIDS_CACHE_LINE_SIZE, 0u);
+  EXPECT_EQ(static_cast<uint8_t *>(second) - static_cast<uint8_t *>(first),
+            static_cast<ptrdiff_t>(EMBEDIDS_CACHE_LINE_SIZE));
+  EXPECT_EQ(arena.used, 3u * EMBEDIDS_CACHE_LINE_SIZE);
+  EXPECT_EQ(static_cast<uint8_t *>(second)[EMBEDIDS_CACHE_LINE_SIZE], 0u);
+}
+
+TEST_F(EmbedIDSArenaTest, ExhaustionAndMisalignmentAreReported) {
+  embedids_arena_t arena;
+  EXPECT_EQ(embedids_arena_init(&arena, block + 8, sizeof(block) - 8),
+            EMBEDIDS_ERROR_ALIGNMENT_ERROR);
+  EXPECT_EQ(embedids_arena_init(&arena, nullptr, 64), EMBEDIDS_ERROR_INVALID_PARAM);
+
+  ASSERT_EQ(embedids_arena_init(&arena, block, 2 * EMBEDIDS_CACHE_LINE_SIZE), EMBEDIDS_OK);
+  void *memory = nullptr;
+  ASSERT_EQ(embedids_arena_alloc(&arena, EMBEDIDS_CACHE_LINE_SIZE, &memory), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_arena_alloc(&arena, EMBEDIDS_CACHE_LINE_SIZE + 1, &memory),
+            EMBEDIDS_ERROR_OUT_OF_MEMORY);
+  EXPECT_EQ(embedids_arena_alloc(&arena, SIZE_MAX, &memory), EMBEDIDS_ERROR_OUT_OF_MEMORY);
+  EXPECT_EQ(embedids_arena_alloc(&arena, EMBEDIDS_CACHE_LINE_SIZE, &memory), EMBEDIDS_OK);
+  EXPECT_EQ(arena.used, arena.size);
+}
+
+// ============================================================================
+// Metric History Tests
+// ============================================================================
+
+TEST_F(EmbedIDSArenaTest, MeasuringMatchesRequiredSize) {
+  size_t required = 0;
+  ASSERT_EQ(embedids_arena_required(metrics, 3, EMBEDIDS_ARENA_CHECKSUMS, &required),
+            EMBEDIDS_OK);
+  EXPECT_EQ(required, EMBEDIDS_ARENA_HISTORY_BYTES(10) + EMBEDIDS_ARENA_HISTORY_BYTES(3) +
+                          EMBEDIDS_ARENA_HISTORY_BYTES(40) + 3 * EMBEDIDS_CACHE_LINE_SIZE);
+
+  embedids_arena_t measure;
+  ASSERT_EQ(embedids_arena_init(&measure, nullptr, 0), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_arena_alloc_histories(&measure, metrics, 3, EMBEDIDS_ARENA_CHECKSUMS),
+            EMBEDIDS_OK);
+  EXPECT_EQ(measure.used, required);
+  EXPECT_EQ(metrics[0].metric.history, nullptr);
+}
+
+TEST_F(EmbedIDSArenaTest, HistoriesCarvedForInit) {
+  size_t required = 0;
+  ASSERT_EQ(embedids_arena_required(metrics, 3, EMBEDIDS_ARENA_CHECKSUMS, &required),
+            EMBEDIDS_OK);
+  ASSERT_LE(required, sizeof(block));
+
+  embedids_arena_t arena;
+  ASSERT_EQ(embedids_arena_init(&arena, block, required), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_arena_alloc_histories(&arena, metrics, 3, EMBEDIDS_ARENA_CHECKSUMS),
+            EMBEDIDS_OK);
+  EXPECT_EQ(arena.used, required);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(metrics[i].metric.history) % EMBEDIDS_CACHE_LINE_SIZE,
+              0u);
+    EXPECT_NE(metrics[i].metric.block_crcs, nullptr);
+  }
+
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  memset(&context, 0, sizeof(context));
+  memset(&system_config, 0, sizeof(system_config));
+  system_config.metrics = metrics;
+  system_config.max_metrics = 3;
+  system_config.num_active_metrics = 3;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 7;
+  for (uint32_t i = 0; i < 50; i++) {
+    ASSERT_EQ(embedids_add_datapoint(&context, "sockets", value, i), EMBEDIDS_OK);
+    ASSERT_EQ(embedids_add_datapoint(&context, "memory", value, i), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(embedids_verify_history(&context, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(metrics[2].metric.current_size, 40u);
+  embedids_cleanup(&context);
+}
+
+TEST_F(EmbedIDSArenaTest, RangeIndexCarvedOnRequest) {
+  const uint32_t options = EMBEDIDS_ARENA_CHECKSUMS | EMBEDIDS_ARENA_RANGE_INDEX;
+  size_t with_index = 0;
+  size_t without = 0;
+  ASSERT_EQ(embedids_arena_required(metrics, 3, options, &with_index), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_arena_required(metrics, 3, EMBEDIDS_ARENA_CHECKSUMS, &without),
+            EMBEDIDS_OK);
+  size_t index_bytes = 0;
+  for (int i = 0; i < 3; i++) {
+    index_bytes += EMBEDIDS_ARENA_ALIGN(
+        EMBEDIDS_RANGE_INDEX_NODES(metrics[i].metric.max_history_size) *
+        sizeof(embedids_range_aggregate_t));
+  }
+  EXPECT_EQ(with_index, without + index_bytes);
+  ASSERT_LE(with_index, sizeof(block));
+
+  embedids_arena_t arena;
+  ASSERT_EQ(embedids_arena_init(&arena, block, with_index), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_arena_alloc_histories(&arena, metrics, 3, options), EMBEDIDS_OK);
+  EXPECT_EQ(arena.used, with_index);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(metrics[i].metric.range_index) %
+                  EMBEDIDS_CACHE_LINE_SIZE,
+              0u);
+  }
+
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  memset(&context, 0, sizeof(context));
+  memset(&system_config, 0, sizeof(system_config));
+  system_config.metrics = metrics;
+  system_config.max_metrics = 3;
+  system_config.num_active_metrics = 3;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < 50; i++) {
+    value.u32 = i;
+    ASSERT_EQ(embedids_add_datapoint(&context, "sockets", value, i), EMBEDIDS_OK);
+  }
+  embedids_range_aggregate_t got;
+  ASSERT_EQ(embedids_query_range(&context, "sockets", 20, 29, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 10u);
+  EXPECT_EQ(got.min.u32, 20u);
+  EXPECT_EQ(got.max.u32, 29u);
+  embedids_cleanup(&context);
+}
+
+TEST_F(EmbedIDSArenaTest, ShortArenaLeavesMetricsUntouched) {
+  size_t required = 0;
+  ASSERT_EQ(embedids_arena_required(metrics, 3, 0, &required), EMBEDIDS_OK);
+
+  embedids_arena_t arena;
+  ASSERT_EQ(embedids_arena_init(&arena, block, required - EMBEDIDS_CACHE_LINE_SIZE),
+            EMBEDIDS_OK);
+  EXPECT_EQ(embedids_arena_alloc_histories(&arena, metrics, 3, 0),
+            EMBEDIDS_ERROR_OUT_OF_MEMORY);
+  EXPECT_EQ(arena.used, 0u);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(metrics[i].metric.history, nullptr);
+  }
+}
@@ -0,0 +1,125 @@
+#include "embedids.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @brief Test fixture for backpressure metrics
+ *
+ * Tests that a backpressure metric refuses points instead of overwriting
+ * unacknowledged ones, and that consumers read and release them in place.
+ */
+class EmbedIDSBackpressureTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history[4];
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(&metric_config, 0, sizeof(metric_config));
+    strncpy(metric_config.metric.name, "auth_failures", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_config.metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_config.metric.history = history;
+    metric_config.metric.max_history_size = 4;
+    metric_config.metric.enabled = true;
+    metric_config.metric.backpressure = true;
+
+    system_config.metrics = &metric_config;
+    system_config.max_metrics = 1;
+    system_config.num_active_metrics = 1;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  embedids_result_t add(uint32_t value) {
+    embedids_metric_value_t metric_value;
+    metric_value.u32 = value;
+    return embedids_add_datapoint(&context, "auth_failures", metric_value, 1000 + value);
+  }
+
+  std::vector<uint32_t> unacked() {
+    embedids_datapoint_span_t span;
+    EXPECT_EQ(embedids_peek_unacked(&context, "auth_failures", &span), EMBEDIDS_OK);
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < span.first_count; ++i) {
+      values.push_back(span.first[i].value.u32);
+    }
+    for (uint32_t i = 0; i < span.second_count; ++i) {
+      values.push_back(span.second[i].value.u32);
+    }
+    return values;
+  }
+};
+
+// ============================================================================
+// Backpressure Tests
+// ============================================================================
+
+TEST_F(EmbedIDSBackpressureTest, FullRingRefusesPoints) {
+  for (uint32_t i = 1; i <= 4; ++i) {
+    ASSERT_EQ(add(i), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(add(5), EMBEDIDS_ERROR_BUFFER_FULL);
+  EXPECT_EQ(metric_config.metric.unacked, 4u);
+  EXPECT_EQ(unacked(), (std::vector<uint32_t>{1, 2, 3, 4}));
+
+  embedids_u32_handle_t handle;
+  ASSERT_EQ(embedids_get_u32_handle(&context, "auth_failures", &handle), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_add_u32(&handle, 5, 2000), EMBEDIDS_ERROR_BUFFER_FULL);
+}
+
+TEST_F(EmbedIDSBackpressureTest, AckReleasesOldestAndSpanWraps) {
+  for (uint32_t i = 1; i <= 4; ++i) {
+    ASSERT_EQ(add(i), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(embedids_ack_datapoints(&context, "auth_failures", 3), EMBEDIDS_OK);
+  ASSERT_EQ(add(5), EMBEDIDS_OK);
+  ASSERT_EQ(add(6), EMBEDIDS_OK);
+
+  // 4 sits at the ring end, 5 and 6 wrapped to its start
+  embedids_datapoint_span_t span;
+  ASSERT_EQ(embedids_peek_unacked(&context, "auth_failures", &span), EMBEDIDS_OK);
+  EXPECT_EQ(span.first, &history[3]);
+  EXPECT_EQ(span.first_count, 1u);
+  EXPECT_EQ(span.second, &history[0]);
+  EXPECT_EQ(span.second_count, 2u);
+  EXPECT_EQ(unacked(), (std::vector<uint32_t>{4, 5, 6}));
+
+  EXPECT_EQ(embedids_ack_datapoints(&context, "auth_failures", 4),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+  ASSERT_EQ(embedids_ack_datapoints(&context, "auth_failures", 3), EMBEDIDS_OK);
+  EXPECT_TRUE(unacked().empty());
+
+  // Acknowledged points remain visible to the algorithms
+  EXPECT_EQ(metric_config.metric.current_size, 4u);
+}
+
+TEST_F(EmbedIDSBackpressureTest, LossyMetricsNeverBlock) {
+  metric_config.metric.backpressure = false;
+  for (uint32_t i = 1; i <= 6; ++i) {
+    ASSERT_EQ(add(i), EMBEDIDS_OK);
+  }
+  EXPECT_TRUE(unacked().empty());
+  EXPECT_EQ(embedids_ack_datapoints(&context, "auth_failures", 1),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+TEST_F(EmbedIDSBackpressureTest, ResetAndSnapshotKeepQueueConsistent) {
+  ASSERT_EQ(add(1), EMBEDIDS_OK);
+  ASSERT_EQ(add(2), EMBEDIDS_OK);
+
+  size_t size = 0;
+  ASSERT_EQ(embedids_snapshot_size(&context, &size), EMBEDIDS_OK);
+  std::vector<uint8_t> snapshot(size);
+  ASSERT_EQ(embedids_snapshot(&context, snapshot.data(), size), EMBEDIDS_OK);
+
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_TRUE(unacked().empty());
+
+  ASSERT_EQ(embedids_restore(&context, snapshot.data(), size), EMBEDIDS_OK);
+  EXPECT_EQ(unacked(), (std::vector<uint32_t>{1, 2}));
+}
@@ -0,0 +1,239 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" uint32_t embedids_crc32c(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief Test fixture for precompiled configuration blobs
+ *
+ * Tests compiling metric configurations into a blob, initializing from it
+ * without copies, rejecting damaged or misplaced blobs, and the deeper
+ * checks in embedids_validate_config.
+ */
+class EmbedIDSBlobTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metrics[2];
+  std::vector<uint64_t> storage; // 8-byte aligned backing for blobs
+  embedids_metric_datapoint_t pool[24];
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(metrics, 0, sizeof(metrics));
+    setupMetric(metrics[0], nullptr, "cpu_usage", EMBEDIDS_METRIC_TYPE_PERCENTAGE, 8);
+    setupMetric(metrics[1], nullptr, "open_files", EMBEDIDS_METRIC_TYPE_UINT32, 16);
+
+    metrics[1].num_algorithms = 1;
+    metrics[1].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    metrics[1].algorithms[0].enabled = true;
+    metrics[1].algorithms[0].config.threshold.max_threshold.u32 = 100;
+    metrics[1].algorithms[0].config.threshold.check_max = true;
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  uint8_t *compile(size_t *size) {
+    EXPECT_EQ(embedids_config_to_blob(metrics, 2, nullptr, 0, size), EMBEDIDS_OK);
+    storage.assign(*size / sizeof(uint64_t) + 2, 0);
+    uint8_t *blob = reinterpret_cast<uint8_t *>(storage.data());
+    EXPECT_EQ(embedids_config_to_blob(metrics, 2, blob, *size, size), EMBEDIDS_OK);
+    return blob;
+  }
+
+  // Recompute the checksum after editing configs, as a forger would
+  void reseal(uint8_t *blob, size_t size) {
+    const size_t header_size = 64, crc_offset = 36;
+    memset(blob + crc_offset, 0, sizeof(uint32_t));
+    uint32_t crc = embedids_crc32c(0, blob, header_size);
+    for (size_t offset = header_size; offset < size; offset += sizeof(embedids_metric_config_t)) {
+      embedids_metric_config_t image;
+      memcpy(&image, blob + offset, sizeof(image));
+      image.metric.history = nullptr;
+      image.metric.block_crcs = nullptr;
+      image.metric.range_index = nullptr;
+      image.metric.current_size = image.metric.write_index = image.metric.unacked = 0;
+      image.metric.sequence = image.metric.stale_crc = image.metric.stale_prefix_crc = 0;
+      crc = embedids_crc32c(crc, &image, sizeof(image));
+    }
+    memcpy(blob + crc_offset, &crc, sizeof(crc));
+  }
+
+  embedids_metric_config_t *blobConfig(uint8_t *blob, uint32_t index) {
+    return reinterpret_cast<embedids_metric_config_t *>(blob + 64) + index;
+  }
+};
+
+// ============================================================================
+// Blob Initialization Tests
+// ============================================================================
+
+TEST_F(EmbedIDSBlobTest, InitFromBlobUsesBlobInPlace) {
+  size_t size = 0;
+  uint8_t *blob = compile(&size);
+
+  embedids_config_blob_info_t info;
+  ASSERT_EQ(embedids_config_blob_info(blob, size, &info), EMBEDIDS_OK);
+  EXPECT_EQ(info.num_metrics, 2u);
+  EXPECT_EQ(info.history_points, 24u);
+
+  ASSERT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_OK);
+  EXPECT_GT((uint8_t *)system_config.metrics, blob);
+  EXPECT_LT((uint8_t *)system_config.metrics, blob + size);
+  EXPECT_EQ(system_config.metrics[0].metric.history, pool);
+  EXPECT_EQ(system_config.metrics[1].metric.history, pool + 8);
+
+  embedids_metric_value_t value;
+  value.u32 = 500;
+  ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, 1000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+
+TEST_F(EmbedIDSBlobTest, RejectsSmallPoolAndMisalignment) {
+  size_t size = 0;
+  uint8_t *blob = compile(&size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 23),
+            EMBEDIDS_ERROR_OUT_OF_MEMORY);
+
+  memmove(blob + 4, blob, size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob + 4, size, pool, 24),
+            EMBEDIDS_ERROR_ALIGNMENT_ERROR);
+  EXPECT_FALSE(embedids_is_initialized(&context));
+}
+
+TEST_F(EmbedIDSBlobTest, RejectsCorruptBlob) {
+  size_t size = 0;
+  uint8_t *blob = compile(&size);
+  blob[size - 1] ^= 0x01;
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  blob = compile(&size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size - 1, pool, 24),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSBlobTest, HeaderIsChecksummed) {
+  size_t size = 0;
+  uint8_t *blob = compile(&size);
+
+  // Claim a one-point pool covers every ring
+  const size_t history_points_offset = 32;
+  uint32_t points = 1;
+  memcpy(blob + history_points_offset, &points, sizeof(points));
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 1),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  EXPECT_FALSE(embedids_is_initialized(&context));
+}
+
+TEST_F(EmbedIDSBlobTest, BlobCanBeInitializedAgain) {
+  size_t size = 0;
+  uint8_t *blob = compile(&size);
+  ASSERT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 500;
+  ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, 1000), EMBEDIDS_OK);
+  embedids_cleanup(&context);
+
+  // Live pointers and ring indices in the blob do not count as damage
+  embedids_config_blob_info_t info;
+  ASSERT_EQ(embedids_config_blob_info(blob, size, &info), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+
+TEST_F(EmbedIDSBlobTest, CustomAlgorithmsCannotBeCompiled) {
+  metrics[0].num_algorithms = 1;
+  metrics[0].algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  size_t size = 0;
+  EXPECT_EQ(embedids_config_to_blob(metrics, 2, nullptr, 0, &size),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+}
+
+TEST_F(EmbedIDSBlobTest, InitRejectsForgedPointers) {
+  static embedids_ensemble_t ensemble;
+  static embedids_alert_state_t alerts[1];
+  static uint8_t state[8];
+  size_t size = 0;
+  uint8_t *blob = compile(&size);
+
+  // Checksummed, but not something embedids_config_to_blob would emit
+  blobConfig(blob, 1)->ensemble = &ensemble;
+  reseal(blob, size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  blob = compile(&size);
+  blobConfig(blob, 1)->alerts = alerts;
+  reseal(blob, size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  blob = compile(&size);
+  blobConfig(blob, 0)->algorithm_state = state;
+  reseal(blob, size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  blob = compile(&size);
+  blobConfig(blob, 1)->algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  reseal(blob, size);
+  EXPECT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+  EXPECT_FALSE(embedids_is_initialized(&context));
+
+  // Ring pointers are outside the checksum and are dropped on init
+  blob = compile(&size);
+  blobConfig(blob, 0)->metric.block_crcs = reinterpret_cast<uint32_t *>(state);
+  ASSERT_EQ(embedids_init_from_blob(&context, &system_config, blob, size, pool, 24),
+            EMBEDIDS_OK);
+  EXPECT_EQ(system_config.metrics[0].metric.block_crcs, nullptr);
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSBlobTest, ValidateConfigChecksMetrics) {
+  embedids_metric_datapoint_t history[2][8];
+  metrics[0].metric.history = history[0];
+  metrics[1].metric.history = history[1];
+  metrics[1].metric.max_history_size = 8;
+  system_config.metrics = metrics;
+  system_config.max_metrics = 2;
+  system_config.num_active_metrics = 2;
+  EXPECT_EQ(embedids_validate_config(&system_config), EMBEDIDS_OK);
+
+  strncpy(metrics[1].metric.name, "cpu_usage", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+  EXPECT_EQ(embedids_validate_config(&system_config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  strncpy(metrics[1].metric.name, "open_files", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+
+  metrics[1].metric.write_index = 8;
+  EXPECT_EQ(embedids_validate_config(&system_config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  metrics[1].metric.write_index = 0;
+
+  metrics[0].metric.history = nullptr;
+  EXPECT_EQ(embedids_validate_config(&system_config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  metrics[0].metric.history = history[0];
+
+  metrics[0].num_algorithms = 1;
+  metrics[0].algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  metrics[0].algorithms[0].enabled = true;
+  EXPECT_EQ(embedids_validate_config(&system_config),
+            EMBEDIDS_ERROR_CUSTOM_ALGORITHM_NULL);
+  metrics[0].algorithms[0].type = (embedids_algorithm_type_t)42;
+  EXPECT_EQ(embedids_validate_config(&system_config),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+  metrics[0].num_algorithms = 0;
+
+  system_config.num_active_metrics = 3;
+  EXPECT_EQ(embedids_validate_config(&system_config), EMBEDIDS_ERROR_CONFIG_INVALID);
+}
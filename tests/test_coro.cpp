@@ -0,0 +1,151 @@
+#include "embedids_coro.hpp"
+#include <coroutine>
+#include <cstring>
+#include <deque>
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @brief Test fixture for the C++20 coroutine analyzer
+ *
+ * Tests that a pass runs in budgeted slices on a single-threaded loop and
+ * that anomalies arrive through the stream in slot order.
+ */
+class EmbedIDSCoroTest : public ::testing::Test {
+protected:
+  /** @brief Minimal run-to-empty event loop */
+  struct Loop {
+    std::deque<std::coroutine_handle<>> ready;
+
+    auto schedule() {
+      struct Post {
+        Loop *loop;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop->ready.push_back(handle); }
+        void await_resume() const noexcept {}
+      };
+      return Post{this};
+    }
+
+    uint32_t run() {
+      uint32_t resumed = 0;
+      while (!ready.empty()) {
+        std::coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+        handle.resume();
+        resumed++;
+      }
+      return resumed;
+    }
+  };
+
+  /** @brief Eagerly started coroutine that owns nothing */
+  struct Task {
+    struct promise_type {
+      Task get_return_object() { return {}; }
+      std::suspend_never initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { std::terminate(); }
+    };
+  };
+
+  static Task collect(embedids::AnomalyStream &stream, std::vector<embedids::Anomaly> &out,
+                      bool &finished) {
+    while (auto anomaly = co_await stream.next()) {
+      out.push_back(*anomaly);
+    }
+    finished = true;
+  }
+
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metrics[5];
+  embedids_metric_datapoint_t history[5][4];
+  Loop loop;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(metrics, 0, sizeof(metrics));
+
+    const char *names[5] = {"m0", "m1", "m2", "m3", "m4"};
+    for (uint32_t i = 0; i < 5; ++i) {
+      strncpy(metrics[i].metric.name, names[i], EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+      metrics[i].metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+      metrics[i].metric.enabled = true;
+      metrics[i].metric.history = history[i];
+      metrics[i].metric.max_history_size = 4;
+      metrics[i].num_algorithms = 1;
+      metrics[i].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+      metrics[i].algorithms[0].enabled = true;
+      metrics[i].algorithms[0].config.threshold.max_threshold.u32 = 10;
+      metrics[i].algorithms[0].config.threshold.check_max = true;
+    }
+    system_config.metrics = metrics;
+    system_config.max_metrics = 5;
+    system_config.num_active_metrics = 5;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+    embedids_metric_value_t value;
+    value.u32 = 50;
+    ASSERT_EQ(embedids_add_datapoint(&context, "m1", value, 1000), EMBEDIDS_OK);
+    ASSERT_EQ(embedids_add_datapoint(&context, "m4", value, 1000), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+};
+
+// ============================================================================
+// Sliced Analysis Tests
+// ============================================================================
+
+TEST_F(EmbedIDSCoroTest, PassRunsInBudgetedSlices) {
+  auto stream = embedids::analyze_async(context, [this] { return loop.schedule(); }, 2);
+  std::vector<embedids::Anomaly> anomalies;
+  bool finished = false;
+  collect(stream, anomalies, finished);
+
+  // First slice ran inline: m0 and the anomaly in m1
+  ASSERT_EQ(anomalies.size(), 1u);
+  EXPECT_EQ(anomalies[0].slot, 1u);
+  EXPECT_STREQ(anomalies[0].name, "m1");
+  EXPECT_EQ(anomalies[0].result, EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_FALSE(finished);
+  ASSERT_EQ(loop.ready.size(), 1u);
+
+  // Two more slices cover m2-m3 and m4
+  EXPECT_EQ(loop.run(), 2u);
+  EXPECT_TRUE(finished);
+  EXPECT_TRUE(stream.done());
+  ASSERT_EQ(anomalies.size(), 2u);
+  EXPECT_STREQ(anomalies[1].name, "m4");
+}
+
+TEST_F(EmbedIDSCoroTest, DisabledMetricsAreSkipped) {
+  metrics[2].metric.enabled = false;
+  auto stream = embedids::analyze_async(context, [this] { return loop.schedule(); });
+  std::vector<embedids::Anomaly> anomalies;
+  bool finished = false;
+  collect(stream, anomalies, finished);
+
+  // One slice per enabled metric after m0, plus the one finding the pass over
+  EXPECT_EQ(loop.run(), 4u);
+  EXPECT_TRUE(finished);
+  ASSERT_EQ(anomalies.size(), 2u);
+  EXPECT_EQ(anomalies[0].slot, 1u);
+  EXPECT_EQ(anomalies[1].slot, 4u);
+}
+
+TEST_F(EmbedIDSCoroTest, UninitializedContextEndsStream) {
+  embedids_cleanup(&context);
+  auto stream = embedids::analyze_async(context, [this] { return loop.schedule(); });
+  std::vector<embedids::Anomaly> anomalies;
+  bool finished = false;
+  collect(stream, anomalies, finished);
+
+  EXPECT_TRUE(finished);
+  ASSERT_EQ(anomalies.size(), 1u);
+  EXPECT_EQ(anomalies[0].result, EMBEDIDS_ERROR_NOT_INITIALIZED);
+  EXPECT_EQ(anomalies[0].name, nullptr);
+}
@@ -0,0 +1,103 @@
+#include "embedids.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for the constexpr C++ configuration builder
+ *
+ * Tests that declared metrics and algorithms are emitted into matching C
+ * structures. Rejected configurations are covered by the compile_fail
+ * tests.
+ */
+class EmbedIDSCppConfigTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+
+  void SetUp() override { memset(&context, 0, sizeof(context)); }
+
+  void TearDown() override { embedids_cleanup(&context); }
+};
+
+namespace {
+
+uint32_t custom_calls = 0;
+
+embedids_result_t count_calls(const embedids_metric_t *metric, const void *config,
+                              void *context) {
+  (void)metric;
+  (void)config;
+  (void)context;
+  custom_calls++;
+  return EMBEDIDS_OK;
+}
+
+constexpr auto cpu = embedids::metric("cpu_usage", EMBEDIDS_METRIC_TYPE_PERCENTAGE, 16)
+                         .with(embedids::threshold().max(90.0f))
+                         .with(embedids::trend(4, 5.0f, 25.0f));
+
+constexpr auto files = embedids::metric("open_files", EMBEDIDS_METRIC_TYPE_UINT32, 8)
+                           .with(embedids::threshold().min(1u).max(100u))
+                           .with(embedids::custom(count_calls))
+                           .backpressure();
+
+constexpr auto door = embedids::metric("door_open", EMBEDIDS_METRIC_TYPE_BOOL, 4).disabled();
+
+using DeviceConfig = embedids::Config<cpu, files, door>;
+
+static_assert(embedids::detail::bounds_ordered(embedids::threshold().min(-10).max(-5)));
+static_assert(!embedids::detail::bounds_ordered(embedids::threshold().min(-5).max(-10)));
+static_assert(embedids::detail::bounds_ordered(embedids::threshold().min(-1).max(2u)));
+
+static_assert(DeviceConfig::num_metrics == 3);
+static_assert(DeviceConfig::history_points == 28);
+
+} // namespace
+
+// ============================================================================
+// Emission Tests
+// ============================================================================
+
+TEST_F(EmbedIDSCppConfigTest, EmitsMatchingSystemConfig) {
+  embedids_system_config_t &config = DeviceConfig::system_config();
+  ASSERT_EQ(config.num_active_metrics, 3u);
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_OK);
+
+  const embedids_metric_config_t &cpu_config = config.metrics[0];
+  EXPECT_STREQ(cpu_config.metric.name, "cpu_usage");
+  EXPECT_EQ(cpu_config.metric.max_history_size, 16u);
+  ASSERT_EQ(cpu_config.num_algorithms, 2u);
+  EXPECT_TRUE(cpu_config.algorithms[0].config.threshold.check_max);
+  EXPECT_FALSE(cpu_config.algorithms[0].config.threshold.check_min);
+  EXPECT_FLOAT_EQ(cpu_config.algorithms[0].config.threshold.max_threshold.f32, 90.0f);
+  EXPECT_EQ(cpu_config.algorithms[1].type, EMBEDIDS_ALGORITHM_TREND);
+  EXPECT_EQ(cpu_config.algorithms[1].config.trend.window_size, 4u);
+
+  const embedids_metric_config_t &files_config = config.metrics[1];
+  EXPECT_EQ(files_config.algorithms[0].config.threshold.min_threshold.u32, 1u);
+  EXPECT_EQ(files_config.algorithms[1].config.custom.function, &count_calls);
+  EXPECT_EQ(files_config.metric.history, cpu_config.metric.history + 16);
+  EXPECT_TRUE(files_config.metric.backpressure);
+  EXPECT_FALSE(cpu_config.metric.backpressure);
+
+  EXPECT_FALSE(config.metrics[2].metric.enabled);
+  EXPECT_EQ(&DeviceConfig::system_config(), &config);
+}
+
+TEST_F(EmbedIDSCppConfigTest, InitializedContextDetects) {
+  ASSERT_EQ(DeviceConfig::init(context), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 50;
+  ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, 1000), EMBEDIDS_OK);
+  uint32_t calls = custom_calls;
+  EXPECT_EQ(embedids_analyze_metric(&context, "open_files"), EMBEDIDS_OK);
+  EXPECT_EQ(custom_calls, calls + 1);
+
+  value.u32 = 0;
+  ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, 2000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "open_files"),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  EXPECT_EQ(embedids_analyze_metric(&context, "door_open"),
+            EMBEDIDS_ERROR_METRIC_DISABLED);
+}
@@ -0,0 +1,193 @@
+#include "embedids.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for typed C++ metrics
+ *
+ * Tests the typed history ring, its kernels, and that exporting it to the
+ * C API gives the same results as analyzing it in C++.
+ */
+class EmbedIDSCppMetricTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history[8];
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(&metric_config, 0, sizeof(metric_config));
+    memset(history, 0, sizeof(history));
+
+    strncpy(metric_config.metric.name, "open_files", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_config.metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_config.metric.history = history;
+    metric_config.metric.max_history_size = 8;
+    metric_config.metric.enabled = true;
+    metric_config.num_algorithms = 1;
+    metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    metric_config.algorithms[0].enabled = true;
+    metric_config.algorithms[0].config.threshold.max_threshold.u32 = 100;
+    metric_config.algorithms[0].config.threshold.check_max = true;
+
+    system_config.metrics = &metric_config;
+    system_config.max_metrics = 1;
+    system_config.num_active_metrics = 1;
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+};
+
+// ============================================================================
+// Ring Tests
+// ============================================================================
+
+TEST_F(EmbedIDSCppMetricTest, RingKeepsNewestPoints) {
+  embedids::Metric<uint32_t, 4> metric;
+  EXPECT_TRUE(metric.empty());
+  for (uint32_t i = 1; i <= 6; ++i) {
+    metric.push(i * 10, i * 1000);
+  }
+
+  ASSERT_EQ(metric.size(), 4u);
+  EXPECT_EQ(metric.at(0), 30u);
+  EXPECT_EQ(metric.at(3), 60u);
+  EXPECT_EQ(metric.latest(), 60u);
+  EXPECT_EQ(metric.timestamp_at(0), 3000u);
+
+  embedids::Summary<uint32_t> summary = metric.summary();
+  EXPECT_EQ(summary.count, 4u);
+  EXPECT_EQ(summary.min, 30u);
+  EXPECT_EQ(summary.max, 60u);
+  EXPECT_FLOAT_EQ(summary.mean, 45.0f);
+  EXPECT_EQ(summary.last_timestamp_ms, 6000u);
+
+  metric.clear();
+  EXPECT_TRUE(metric.empty());
+}
+
+// ============================================================================
+// Kernel Tests
+// ============================================================================
+
+TEST_F(EmbedIDSCppMetricTest, ThresholdKernelsRunInOrder) {
+  embedids::Metric<uint64_t, 8> metric;
+  constexpr auto range = embedids::Threshold<uint64_t>{}.min(5).max(50);
+  EXPECT_EQ(metric.analyze(range), EMBEDIDS_OK);
+
+  metric.push(10, 1000);
+  EXPECT_EQ(metric.analyze(range), EMBEDIDS_OK);
+  metric.push(60, 2000);
+  EXPECT_EQ(metric.analyze(range), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  int calls = 0;
+  auto counter = [&calls](const auto &) {
+    calls++;
+    return EMBEDIDS_OK;
+  };
+  EXPECT_EQ(metric.analyze(counter, range, counter), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(calls, 1);
+}
+
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+TEST_F(EmbedIDSCppMetricTest, PercentageMetricUsesFloatKernels) {
+  embedids::Metric<float, 16, EMBEDIDS_METRIC_TYPE_PERCENTAGE> cpu;
+  static_assert(decltype(cpu)::type == EMBEDIDS_METRIC_TYPE_PERCENTAGE);
+
+  cpu.push(10.0f, 1000);
+  cpu.push(30.0f, 2000);
+  cpu.push(50.0f, 3000);
+  EXPECT_EQ(cpu.trend(), EMBEDIDS_TREND_INCREASING);
+  EXPECT_EQ(cpu.analyze(embedids::Threshold<float>{}.max(40.0f)),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+#endif
+
+// ============================================================================
+// C API Adapter Tests
+// ============================================================================
+
+TEST_F(EmbedIDSCppMetricTest, ExportMatchesCAnalysis) {
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  embedids::Metric<uint32_t, 8> metric;
+  for (uint32_t i = 0; i < 10; ++i) {
+    metric.push(200 - i * 20, 1000 + i);
+  }
+  ASSERT_EQ(metric.export_to(context, metric_config.metric), EMBEDIDS_OK);
+
+  embedids_trend_t trend;
+  ASSERT_EQ(embedids_get_trend(&context, "open_files", &trend), EMBEDIDS_OK);
+  EXPECT_EQ(trend, metric.trend());
+  EXPECT_EQ(trend, EMBEDIDS_TREND_DECREASING);
+
+  embedids_metric_summary_t summary;
+  ASSERT_EQ(embedids_get_summary(&context, "open_files", &summary), EMBEDIDS_OK);
+  EXPECT_EQ(summary.count, metric.summary().count);
+  EXPECT_EQ(summary.min.u32, metric.summary().min);
+  EXPECT_EQ(summary.last.u32, metric.latest());
+  EXPECT_EQ(summary.first_timestamp_ms, metric.timestamp_at(0));
+
+  EXPECT_EQ(embedids_analyze_metric(&context, "open_files"),
+            metric.analyze(embedids::Threshold<uint32_t>{}.max(100)));
+}
+
+static embedids_result_t count_stream(const embedids_metric_t *metric,
+                                      const embedids_datapoint_span_t *points,
+                                      const void *config, void *state) {
+  (void)metric;
+  (void)config;
+  *static_cast<uint32_t *>(state) += points->first_count + points->second_count;
+  return EMBEDIDS_OK;
+}
+
+TEST_F(EmbedIDSCppMetricTest, ExportKeepsLibraryStateInStep) {
+  uint32_t block_crcs[EMBEDIDS_INTEGRITY_BLOCKS(8)];
+  embedids_range_aggregate_t range_index[EMBEDIDS_RANGE_INDEX_NODES(8)];
+  uint32_t streamed = 0;
+  embedids_stream_instance_t instances[2] = {{nullptr, 0}, {&streamed, 0}};
+  metric_config.metric.block_crcs = block_crcs;
+  metric_config.metric.range_index = range_index;
+  metric_config.num_algorithms = 2;
+  metric_config.algorithms[1].type = EMBEDIDS_ALGORITHM_STREAM;
+  metric_config.algorithms[1].enabled = true;
+  metric_config.algorithms[1].config.stream.function = count_stream;
+  metric_config.stream_instances = instances;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  embedids::Metric<uint32_t, 8> metric;
+  for (uint32_t i = 0; i < 5; ++i) {
+    metric.push(10 + i, 1000 + i);
+  }
+  ASSERT_EQ(metric.export_to(context, metric_config.metric), EMBEDIDS_OK);
+
+  // Checksums match, the range index covers the points and the stream
+  // algorithm receives them as new
+  EXPECT_EQ(embedids_verify_history(&context, "open_files"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "open_files"), EMBEDIDS_OK);
+  EXPECT_EQ(streamed, 5u);
+  embedids_range_aggregate_t aggregate;
+  ASSERT_EQ(embedids_query_range(&context, "open_files", 1001, 1003, &aggregate), EMBEDIDS_OK);
+  EXPECT_EQ(aggregate.count, 3u);
+  EXPECT_EQ(aggregate.max.u32, 13u);
+
+  // A metric outside the context is left untouched
+  embedids_metric_config_t stranger = metric_config;
+  embedids_metric_datapoint_t other[8];
+  stranger.metric.history = other;
+  EXPECT_EQ(metric.export_to(context, stranger.metric), EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+}
+
+TEST_F(EmbedIDSCppMetricTest, ExportRejectsMismatchedMetric) {
+  embedids::Metric<uint64_t, 4> wide;
+  wide.push(1, 1000);
+  EXPECT_EQ(wide.export_to(context, metric_config.metric), EMBEDIDS_ERROR_INVALID_PARAM);
+
+  embedids::Metric<uint32_t, 16> large;
+  for (uint32_t i = 0; i < 9; ++i) {
+    large.push(i, i);
+  }
+  EXPECT_EQ(large.export_to(context, metric_config.metric), EMBEDIDS_ERROR_BUFFER_FULL);
+}
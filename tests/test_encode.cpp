@@ -0,0 +1,243 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for window summaries and the compact frame encoder
+ *
+ * Tests summary computation over the ring, round-tripping alert and
+ * summary records, and that full buffers never receive partial records.
+ */
+class EmbedIDSEncodeTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_metric_config_t metric_configs[2];
+  embedids_metric_datapoint_t connections_history[4];
+  embedids_metric_datapoint_t cpu_history[4];
+  embedids_system_config_t system_config;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(metric_configs, 0, sizeof(metric_configs));
+    setupMetric(metric_configs[0], connections_history, "connections",
+                EMBEDIDS_METRIC_TYPE_UINT32, 4);
+    setupMetric(metric_configs[1], cpu_history, "cpu_usage", EMBEDIDS_METRIC_TYPE_PERCENTAGE,
+                4);
+
+    memset(&system_config, 0, sizeof(system_config));
+    system_config.metrics = metric_configs;
+    system_config.max_metrics = 2;
+    system_config.num_active_metrics = 2;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+};
+
+// ============================================================================
+// Summary Tests
+// ============================================================================
+
+TEST_F(EmbedIDSEncodeTest, SummaryCoversWrappedWindow) {
+  const uint32_t values[] = {50, 10, 70, 30, 20, 40};
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < 6; i++) {
+    value.u32 = values[i];
+    ASSERT_EQ(embedids_add_datapoint(&context, "connections", value, 1000 + i),
+              EMBEDIDS_OK);
+  }
+
+  // Window holds the last four points: 70, 30, 20, 40
+  embedids_metric_summary_t summary;
+  ASSERT_EQ(embedids_get_summary(&context, "connections", &summary), EMBEDIDS_OK);
+  EXPECT_EQ(summary.count, 4u);
+  EXPECT_EQ(summary.min.u32, 20u);
+  EXPECT_EQ(summary.max.u32, 70u);
+  EXPECT_EQ(summary.last.u32, 40u);
+  EXPECT_FLOAT_EQ(summary.mean, 40.0f);
+  EXPECT_EQ(summary.first_timestamp_ms, 1002u);
+  EXPECT_EQ(summary.last_timestamp_ms, 1005u);
+
+  ASSERT_EQ(embedids_get_summary(&context, "cpu_usage", &summary), EMBEDIDS_OK);
+  EXPECT_EQ(summary.count, 0u);
+  EXPECT_EQ(embedids_get_summary(&context, "missing", &summary),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+}
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+TEST_F(EmbedIDSEncodeTest, FrameRoundTrip) {
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < 3; i++) {
+    value.u32 = 100 * (i + 1);
+    ASSERT_EQ(embedids_add_datapoint(&context, "connections", value, 5000 + i),
+              EMBEDIDS_OK);
+    value.f32 = 12.5f * (float)(i + 1);
+    ASSERT_EQ(embedids_add_datapoint(&context, "cpu_usage", value, 5000 + i),
+              EMBEDIDS_OK);
+  }
+
+  uint8_t frame[128];
+  embedids_encoder_t encoder;
+  ASSERT_EQ(embedids_encoder_begin(&encoder, frame, sizeof(frame), 5000), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_encode_alert(&encoder, 0, EMBEDIDS_ERROR_THRESHOLD_EXCEEDED, 5002),
+            EMBEDIDS_OK);
+  uint32_t cursor = 0;
+  ASSERT_EQ(embedids_encode_summaries(&encoder, &context, &cursor), EMBEDIDS_OK);
+  EXPECT_EQ(encoder.records, 3u);
+  EXPECT_EQ(cursor, 2u);
+  size_t length = 0;
+  ASSERT_EQ(embedids_encoder_finish(&encoder, &length), EMBEDIDS_OK);
+  EXPECT_LT(length, 48u);
+
+  embedids_decoder_t decoder;
+  embedids_record_t record;
+  ASSERT_EQ(embedids_decoder_begin(&decoder, frame, length), EMBEDIDS_OK);
+
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.kind, EMBEDIDS_RECORD_ALERT);
+  EXPECT_EQ(record.metric_index, 0u);
+  EXPECT_EQ(record.result, EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(record.timestamp_ms, 5002u);
+
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.kind, EMBEDIDS_RECORD_SUMMARY);
+  EXPECT_EQ(record.type, EMBEDIDS_METRIC_TYPE_UINT32);
+  EXPECT_EQ(record.summary.count, 3u);
+  EXPECT_EQ(record.summary.min.u32, 100u);
+  EXPECT_EQ(record.summary.max.u32, 300u);
+  EXPECT_EQ(record.summary.first_timestamp_ms, 5000u);
+  EXPECT_EQ(record.summary.last_timestamp_ms, 5002u);
+
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.metric_index, 1u);
+  EXPECT_EQ(record.type, EMBEDIDS_METRIC_TYPE_PERCENTAGE);
+  EXPECT_FLOAT_EQ(record.summary.max.f32, 37.5f);
+  EXPECT_FLOAT_EQ(record.summary.mean, 25.0f);
+
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.kind, EMBEDIDS_RECORD_END);
+}
+
+TEST_F(EmbedIDSEncodeTest, TypesUseFixedWireCodes) {
+  uint8_t frame[32];
+  embedids_encoder_t encoder;
+  embedids_metric_summary_t summary;
+  memset(&summary, 0, sizeof(summary));
+  ASSERT_EQ(embedids_encoder_begin(&encoder, frame, sizeof(frame), 0), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_encode_summary(&encoder, 1, EMBEDIDS_METRIC_TYPE_PERCENTAGE, &summary),
+            EMBEDIDS_OK);
+
+  // Header, base, tag and index come first; percentage is code 4 whether or
+  // not this build has the double type ahead of it
+  EXPECT_EQ(frame[4], 4u);
+
+  // A double sent by a build that has it decodes only where doubles exist
+  const uint8_t doubles[] = {0xE1, 0x00, EMBEDIDS_RECORD_SUMMARY, 0x00, 0x03, 0x00,
+                             EMBEDIDS_RECORD_END};
+  embedids_decoder_t decoder;
+  embedids_record_t record;
+  ASSERT_EQ(embedids_decoder_begin(&decoder, doubles, sizeof(doubles)), EMBEDIDS_OK);
+#if EMBEDIDS_ENABLE_FLOATING_POINT && EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.type, EMBEDIDS_METRIC_TYPE_DOUBLE);
+#else
+  EXPECT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+#endif
+}
+
+// ============================================================================
+// Buffer Limit Tests
+// ============================================================================
+
+TEST_F(EmbedIDSEncodeTest, FullBufferKeepsFrameValid) {
+  uint8_t frame[16];
+  embedids_encoder_t encoder;
+  ASSERT_EQ(embedids_encoder_begin(&encoder, frame, sizeof(frame), 0), EMBEDIDS_OK);
+
+  uint32_t accepted = 0;
+  embedids_result_t result = EMBEDIDS_OK;
+  while (result == EMBEDIDS_OK) {
+    result = embedids_encode_alert(&encoder, 3, EMBEDIDS_ERROR_TREND_ANOMALY, accepted);
+    if (result == EMBEDIDS_OK) {
+      accepted++;
+    }
+  }
+  EXPECT_EQ(result, EMBEDIDS_ERROR_BUFFER_FULL);
+  EXPECT_EQ(encoder.records, accepted);
+
+  // Everything that was accepted decodes, followed by the end marker
+  size_t length = 0;
+  ASSERT_EQ(embedids_encoder_finish(&encoder, &length), EMBEDIDS_OK);
+  EXPECT_LE(length, sizeof(frame));
+  embedids_decoder_t decoder;
+  embedids_record_t record;
+  ASSERT_EQ(embedids_decoder_begin(&decoder, frame, length), EMBEDIDS_OK);
+  for (uint32_t i = 0; i < accepted; i++) {
+    ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+    EXPECT_EQ(record.timestamp_ms, i);
+  }
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.kind, EMBEDIDS_RECORD_END);
+}
+
+TEST_F(EmbedIDSEncodeTest, SummariesContinueInTheNextFrame) {
+  embedids_metric_value_t value;
+  value.u32 = 300000;
+  ASSERT_EQ(embedids_add_datapoint(&context, "connections", value, 300000), EMBEDIDS_OK);
+  value.f32 = 42.0f;
+  ASSERT_EQ(embedids_add_datapoint(&context, "cpu_usage", value, 300000), EMBEDIDS_OK);
+
+  // Room for one summary per frame
+  uint8_t frame[28];
+  embedids_encoder_t encoder;
+  uint32_t cursor = 0;
+  ASSERT_EQ(embedids_encoder_begin(&encoder, frame, sizeof(frame), 0), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_encode_summaries(&encoder, &context, &cursor),
+            EMBEDIDS_ERROR_BUFFER_FULL);
+  EXPECT_EQ(encoder.records, 1u);
+  EXPECT_EQ(cursor, 1u);
+
+  size_t length = 0;
+  embedids_decoder_t decoder;
+  embedids_record_t record;
+  ASSERT_EQ(embedids_encoder_finish(&encoder, &length), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_decoder_begin(&decoder, frame, length), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.metric_index, 0u);
+  EXPECT_EQ(record.summary.max.u32, 300000u);
+
+  ASSERT_EQ(embedids_encoder_begin(&encoder, frame, sizeof(frame), 0), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_encode_summaries(&encoder, &context, &cursor), EMBEDIDS_OK);
+  EXPECT_EQ(encoder.records, 1u);
+  EXPECT_EQ(cursor, 2u);
+  ASSERT_EQ(embedids_encoder_finish(&encoder, &length), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_decoder_begin(&decoder, frame, length), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_OK);
+  EXPECT_EQ(record.metric_index, 1u);
+  EXPECT_FLOAT_EQ(record.summary.last.f32, 42.0f);
+}
+
+TEST_F(EmbedIDSEncodeTest, RejectsTimestampBeforeBaseAndBadFrames) {
+  uint8_t frame[32];
+  embedids_encoder_t encoder;
+  ASSERT_EQ(embedids_encoder_begin(&encoder, frame, sizeof(frame), 1000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_encode_alert(&encoder, 0, EMBEDIDS_ERROR_TREND_ANOMALY, 999),
+            EMBEDIDS_ERROR_TIMESTAMP_INVALID);
+  EXPECT_EQ(encoder.records, 0u);
+
+  const uint8_t garbage[] = {0x00, 0x01, 0x02};
+  embedids_decoder_t decoder;
+  EXPECT_EQ(embedids_decoder_begin(&decoder, garbage, sizeof(garbage)),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  // Truncated alert record
+  ASSERT_EQ(embedids_encode_alert(&encoder, 0, EMBEDIDS_ERROR_TREND_ANOMALY, 300000),
+            EMBEDIDS_OK);
+  embedids_record_t record;
+  ASSERT_EQ(embedids_decoder_begin(&decoder, frame, encoder.length - 1), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_decoder_next(&decoder, &record), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
@@ -731,3 +731,284 @@ TEST_F(EmbedIDSExtensibleTest, CustomAlgorithmMetricTypeValidation) {
   EXPECT_EQ(embedids_analyze_metric(&context, "type_test"), EMBEDIDS_OK);
   EXPECT_GT(call_count, 0);
 }
+
+// ============================================================================
+// Shared Algorithm Set Tests
+// ============================================================================
+
+TEST_F(EmbedIDSExtensibleTest, SharedSetUsesPerMetricState) {
+  // Counts its own calls in whatever state block the metric provides
+  auto counting_algorithm = [](const embedids_metric_t *metric, const void *config,
+                               void *context) -> embedids_result_t {
+    (void)metric;
+    (void)config;
+    (*static_cast<uint32_t *>(context))++;
+    return EMBEDIDS_OK;
+  };
+
+  embedids_algorithm_t definitions[2];
+  memset(definitions, 0, sizeof(definitions));
+  definitions[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  definitions[0].enabled = true;
+  definitions[0].config.threshold.max_threshold.u32 = 100;
+  definitions[0].config.threshold.check_max = true;
+  definitions[1].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  definitions[1].enabled = true;
+  definitions[1].config.custom.function = counting_algorithm;
+  const embedids_algorithm_set_t shared = {definitions, 2};
+
+  embedids_metric_config_t metric_configs[2];
+  embedids_metric_datapoint_t history[2][4];
+  uint32_t calls[2] = {0, 0};
+  const char *names[2] = {"eth0_rx", "eth1_rx"};
+  memset(metric_configs, 0, sizeof(metric_configs));
+  for (int i = 0; i < 2; i++) {
+    strncpy(metric_configs[i].metric.name, names[i], EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_configs[i].metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_configs[i].metric.enabled = true;
+    metric_configs[i].metric.history = history[i];
+    metric_configs[i].metric.max_history_size = 4;
+    metric_configs[i].algorithm_set = &shared;
+    metric_configs[i].algorithm_state = &calls[i];
+  }
+  ASSERT_EQ(initializeWithMetrics(metric_configs, 2), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 50;
+  ASSERT_EQ(embedids_add_datapoint(&context, "eth0_rx", value, 1000), EMBEDIDS_OK);
+  value.u32 = 500;
+  ASSERT_EQ(embedids_add_datapoint(&context, "eth1_rx", value, 1000), EMBEDIDS_OK);
+
+  EXPECT_EQ(embedids_analyze_metric(&context, "eth0_rx"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "eth0_rx"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "eth1_rx"), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  // The threshold stopped eth1_rx before its custom algorithm ran
+  EXPECT_EQ(calls[0], 2u);
+  EXPECT_EQ(calls[1], 0u);
+}
+
+TEST_F(EmbedIDSExtensibleTest, SharedSetValidation) {
+  embedids_algorithm_t definition;
+  memset(&definition, 0, sizeof(definition));
+  definition.type = EMBEDIDS_ALGORITHM_CUSTOM;
+  definition.enabled = true;
+  const embedids_algorithm_set_t shared = {&definition, 1};
+
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history_buffer[4];
+  setupCustomMetric(metric_config, history_buffer, "shared", EMBEDIDS_METRIC_TYPE_UINT32, 4,
+                    nullptr);
+  metric_config.algorithm_set = &shared;
+  embedids_system_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.metrics = &metric_config;
+  config.max_metrics = 1;
+  config.num_active_metrics = 1;
+
+  // Own algorithms and a shared set are mutually exclusive
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  // Set entries are checked like embedded ones
+  metric_config.num_algorithms = 0;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CUSTOM_ALGORITHM_NULL);
+
+  const embedids_algorithm_set_t missing = {nullptr, 1};
+  metric_config.algorithm_set = &missing;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  // Sets are pointers and cannot be compiled into a blob
+  metric_config.algorithm_set = &shared;
+  size_t blob_size = 0;
+  EXPECT_EQ(embedids_config_to_blob(&metric_config, 1, nullptr, 0, &blob_size),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+}
+
+// ============================================================================
+// Stream Algorithm Tests
+// ============================================================================
+
+/**
+ * @brief State of a streaming detector that flags values above a limit
+ */
+typedef struct {
+  uint32_t inits;
+  uint32_t resets;
+  uint32_t calls;
+  uint32_t points_seen;
+  uint64_t last_timestamp;
+} stream_state_t;
+
+static embedids_result_t stream_limit(const embedids_metric_t *metric,
+                                      const embedids_datapoint_span_t *points,
+                                      const void *config, void *state) {
+  (void)metric;
+  stream_state_t *s = static_cast<stream_state_t *>(state);
+  uint32_t limit = *static_cast<const uint32_t *>(config);
+  embedids_result_t result = EMBEDIDS_OK;
+  s->calls++;
+  EMBEDIDS_SPAN_FOREACH(points, point) {
+    EXPECT_GT(point->timestamp_ms, s->last_timestamp); // Never redelivered
+    s->last_timestamp = point->timestamp_ms;
+    s->points_seen++;
+    if (point->value.u32 > limit) {
+      result = EMBEDIDS_ERROR_THRESHOLD_EXCEEDED;
+    }
+  }
+  return result;
+}
+
+static void stream_init(const embedids_metric_t *metric, const void *config, void *state) {
+  (void)metric;
+  (void)config;
+  stream_state_t *s = static_cast<stream_state_t *>(state);
+  uint32_t inits = s->inits;
+  memset(s, 0, sizeof(*s));
+  s->inits = inits + 1;
+}
+
+static void stream_reset(const embedids_metric_t *metric, const void *config, void *state) {
+  (void)metric;
+  (void)config;
+  static_cast<stream_state_t *>(state)->resets++;
+}
+
+TEST_F(EmbedIDSExtensibleTest, StreamAlgorithmSeesOnlyNewPoints) {
+  static const uint32_t limit = 100;
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history_buffer[4];
+  stream_state_t state = {};
+  embedids_stream_instance_t instances[1] = {{&state, 0}};
+  setupCustomMetric(metric_config, history_buffer, "stream", EMBEDIDS_METRIC_TYPE_UINT32, 4,
+                    nullptr);
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_STREAM;
+  metric_config.algorithms[0].config.stream.function = stream_limit;
+  metric_config.algorithms[0].config.stream.config = const_cast<uint32_t *>(&limit);
+  metric_config.algorithms[0].config.stream.init = stream_init;
+  metric_config.stream_instances = instances;
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+  EXPECT_EQ(state.inits, 1u);
+
+  embedids_metric_value_t value;
+  uint64_t timestamp = 1000;
+  for (int i = 0; i < 3; i++) {
+    value.u32 = 10;
+    ASSERT_EQ(embedids_add_datapoint(&context, "stream", value, timestamp++), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(embedids_analyze_metric(&context, "stream"), EMBEDIDS_OK);
+  EXPECT_EQ(state.points_seen, 3u);
+
+  // Nothing new: the algorithm is not called
+  EXPECT_EQ(embedids_analyze_metric(&context, "stream"), EMBEDIDS_OK);
+  EXPECT_EQ(state.calls, 1u);
+
+  value.u32 = 500;
+  ASSERT_EQ(embedids_add_datapoint(&context, "stream", value, timestamp++), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "stream"), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(state.points_seen, 4u);
+
+  // Once reported, the spike is old news
+  value.u32 = 20;
+  ASSERT_EQ(embedids_add_datapoint(&context, "stream", value, timestamp++), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "stream"), EMBEDIDS_OK);
+  EXPECT_EQ(state.points_seen, 5u);
+
+  // When the ring laps between calls only the stored points are delivered
+  for (int i = 0; i < 7; i++) {
+    ASSERT_EQ(embedids_add_datapoint(&context, "stream", value, timestamp++), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(embedids_analyze_metric(&context, "stream"), EMBEDIDS_OK);
+  EXPECT_EQ(state.points_seen, 9u);
+  EXPECT_EQ(state.last_timestamp, timestamp - 1);
+}
+
+TEST_F(EmbedIDSExtensibleTest, StreamInstancesRestartOnReset) {
+  static const uint32_t limit = 100;
+  embedids_algorithm_t definition;
+  memset(&definition, 0, sizeof(definition));
+  definition.type = EMBEDIDS_ALGORITHM_STREAM;
+  definition.enabled = true;
+  definition.config.stream.function = stream_limit;
+  definition.config.stream.config = const_cast<uint32_t *>(&limit);
+  definition.config.stream.init = stream_init;
+  definition.config.stream.reset = stream_reset;
+  const embedids_algorithm_set_t shared = {&definition, 1};
+
+  // Two metrics share the definition but keep their own instance state
+  embedids_metric_config_t metric_configs[2];
+  embedids_metric_datapoint_t history[2][4];
+  stream_state_t states[2] = {};
+  embedids_stream_instance_t instances[2][1] = {{{&states[0], 0}}, {{&states[1], 0}}};
+  const char *names[2] = {"eth0_rx", "eth1_rx"};
+  memset(metric_configs, 0, sizeof(metric_configs));
+  for (int i = 0; i < 2; i++) {
+    strncpy(metric_configs[i].metric.name, names[i], EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_configs[i].metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_configs[i].metric.enabled = true;
+    metric_configs[i].metric.history = history[i];
+    metric_configs[i].metric.max_history_size = 4;
+    metric_configs[i].algorithm_set = &shared;
+    metric_configs[i].stream_instances = instances[i];
+  }
+
+  // Points stored before init are delivered on the first analysis
+  history[1][0].timestamp_ms = 1;
+  history[1][0].value.u32 = 7;
+  metric_configs[1].metric.current_size = 1;
+  metric_configs[1].metric.write_index = 1;
+  ASSERT_EQ(initializeWithMetrics(metric_configs, 2), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 5;
+  ASSERT_EQ(embedids_add_datapoint(&context, "eth0_rx", value, 1000), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_add_datapoint(&context, "eth0_rx", value, 1001), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+  EXPECT_EQ(states[0].points_seen, 2u);
+  EXPECT_EQ(states[1].points_seen, 1u);
+
+  // Reset runs the reset hook and forgets the points that were pending
+  ASSERT_EQ(embedids_add_datapoint(&context, "eth0_rx", value, 1002), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_EQ(states[0].resets, 1u);
+  EXPECT_EQ(states[0].inits, 1u);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+  EXPECT_EQ(states[0].calls, 1u);
+
+  ASSERT_EQ(embedids_add_datapoint(&context, "eth0_rx", value, 1003), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+  EXPECT_EQ(states[0].points_seen, 3u);
+  EXPECT_EQ(states[1].points_seen, 1u);
+}
+
+TEST_F(EmbedIDSExtensibleTest, StreamAlgorithmValidation) {
+  stream_state_t state = {};
+  embedids_stream_instance_t instance = {&state, 0};
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history_buffer[4];
+  setupCustomMetric(metric_config, history_buffer, "stream", EMBEDIDS_METRIC_TYPE_UINT32, 4,
+                    nullptr);
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_STREAM;
+  metric_config.algorithms[0].config.stream.function = stream_limit;
+  embedids_system_config_t config;
+  memset(&config, 0, sizeof(config));
+  config.metrics = &metric_config;
+  config.max_metrics = 1;
+  config.num_active_metrics = 1;
+
+  // Stream algorithms need somewhere to keep their instances
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CONFIG_INVALID);
+  metric_config.stream_instances = &instance;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_OK);
+
+  metric_config.algorithms[0].config.stream.function = nullptr;
+  EXPECT_EQ(embedids_validate_config(&config), EMBEDIDS_ERROR_CUSTOM_ALGORITHM_NULL);
+  metric_config.algorithms[0].config.stream.function = stream_limit;
+
+  // Neither blobs nor fleets can carry per-metric instances
+  size_t blob_size = 0;
+  EXPECT_EQ(embedids_config_to_blob(&metric_config, 1, nullptr, 0, &blob_size),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+  embedids_fleet_memory_t report;
+  EXPECT_EQ(embedids_fleet_memory(&metric_config, 1, 2, &report),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+}
@@ -0,0 +1,221 @@
+#include "embedids.h"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @brief Test fixture for fleet mode
+ *
+ * Tests that many devices share one schema while keeping independent
+ * rings in a single arena, and that batched analysis reports each
+ * device's detections.
+ */
+class EmbedIDSFleetTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kDevices = 1000;
+
+  embedids_metric_config_t schema[2];
+  embedids_fleet_t fleet;
+  std::vector<uint64_t> arena;
+
+  void SetUp() override {
+    memset(schema, 0, sizeof(schema));
+    memset(&fleet, 0, sizeof(fleet));
+
+    strncpy(schema[0].metric.name, "cpu", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    schema[0].metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    schema[0].metric.max_history_size = 4;
+    schema[0].metric.enabled = true;
+    schema[0].num_algorithms = 1;
+    schema[0].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    schema[0].algorithms[0].enabled = true;
+    schema[0].algorithms[0].config.threshold.max_threshold.u32 = 90;
+    schema[0].algorithms[0].config.threshold.check_max = true;
+
+    strncpy(schema[1].metric.name, "sockets", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    schema[1].metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    schema[1].metric.max_history_size = 3;
+    schema[1].metric.enabled = true;
+    schema[1].num_algorithms = 1;
+    schema[1].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    schema[1].algorithms[0].enabled = true;
+    schema[1].algorithms[0].config.threshold.max_threshold.u32 = 100;
+    schema[1].algorithms[0].config.threshold.check_max = true;
+  }
+
+  void InitFleet(uint32_t devices) {
+    embedids_fleet_memory_t report;
+    ASSERT_EQ(embedids_fleet_memory(schema, 2, devices, &report), EMBEDIDS_OK);
+    arena.assign(report.arena_bytes / sizeof(uint64_t), 0xFFFFFFFFFFFFFFFFull);
+    ASSERT_EQ(embedids_fleet_init(&fleet, schema, 2, devices, arena.data(), report.arena_bytes),
+              EMBEDIDS_OK);
+  }
+
+  embedids_result_t Add(uint32_t device, uint32_t metric, uint32_t value) {
+    embedids_metric_value_t v;
+    v.u32 = value;
+    return embedids_fleet_add_datapoint(&fleet, device, metric, v, 1000);
+  }
+};
+
+// ============================================================================
+// Layout Tests
+// ============================================================================
+
+TEST_F(EmbedIDSFleetTest, MemoryReportCoversRingsOnly) {
+  embedids_fleet_memory_t report;
+  ASSERT_EQ(embedids_fleet_memory(schema, 2, kDevices, &report), EMBEDIDS_OK);
+
+  // Two ring headers and seven points, padded to the arena alignment
+  size_t raw = 2 * 2 * sizeof(uint32_t) + 7 * sizeof(embedids_metric_datapoint_t);
+  EXPECT_GE(report.device_bytes, raw);
+  EXPECT_LT(report.device_bytes, raw + EMBEDIDS_FLEET_ARENA_ALIGNMENT);
+  EXPECT_EQ(report.device_bytes % EMBEDIDS_FLEET_ARENA_ALIGNMENT, 0u);
+  EXPECT_EQ(report.arena_bytes, report.device_bytes * kDevices);
+
+  // Per-device cost is a fraction of a full metric configuration
+  EXPECT_LT(report.device_bytes, 2 * sizeof(embedids_metric_config_t));
+  EXPECT_GE(report.shared_bytes, 2 * sizeof(embedids_metric_config_t));
+}
+
+TEST_F(EmbedIDSFleetTest, InitChecksArena) {
+  embedids_fleet_memory_t report;
+  ASSERT_EQ(embedids_fleet_memory(schema, 2, 4, &report), EMBEDIDS_OK);
+  arena.assign(report.arena_bytes / sizeof(uint64_t) + 1, 0);
+
+  EXPECT_EQ(embedids_fleet_init(&fleet, schema, 2, 4, arena.data(), report.arena_bytes - 1),
+            EMBEDIDS_ERROR_OUT_OF_MEMORY);
+  EXPECT_EQ(embedids_fleet_init(&fleet, schema, 2, 4,
+                                reinterpret_cast<uint8_t *>(arena.data()) + 1,
+                                report.arena_bytes),
+            EMBEDIDS_ERROR_ALIGNMENT_ERROR);
+  EXPECT_EQ(embedids_fleet_init(&fleet, schema, 2, 4, arena.data(), report.arena_bytes),
+            EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSFleetTest, InvalidSchemaIsRejected) {
+  embedids_fleet_memory_t report;
+  strncpy(schema[1].metric.name, "cpu", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+  EXPECT_EQ(embedids_fleet_memory(schema, 2, 4, &report), EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  strncpy(schema[1].metric.name, "sockets", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+  schema[1].metric.max_history_size = 0;
+  EXPECT_EQ(embedids_fleet_memory(schema, 2, 4, &report), EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  schema[1].metric.max_history_size = 3;
+  schema[1].algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  EXPECT_EQ(embedids_fleet_memory(schema, 2, 4, &report), EMBEDIDS_ERROR_CUSTOM_ALGORITHM_NULL);
+}
+
+// ============================================================================
+// Ingest and Analysis Tests
+// ============================================================================
+
+TEST_F(EmbedIDSFleetTest, DevicesKeepSeparateRings) {
+  InitFleet(kDevices);
+  uint32_t cpu = 0;
+  uint32_t sockets = 0;
+  ASSERT_EQ(embedids_fleet_find_metric(&fleet, "cpu", &cpu), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_fleet_find_metric(&fleet, "sockets", &sockets), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_find_metric(&fleet, "memory", &cpu), EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+
+  for (uint32_t d = 0; d < kDevices; d++) {
+    ASSERT_EQ(Add(d, cpu, 10), EMBEDIDS_OK);
+    ASSERT_EQ(Add(d, sockets, 20), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(Add(7, cpu, 95), EMBEDIDS_OK);
+  ASSERT_EQ(Add(512, sockets, 150), EMBEDIDS_OK);
+  ASSERT_EQ(Add(900, cpu, 99), EMBEDIDS_OK);
+  ASSERT_EQ(Add(900, sockets, 101), EMBEDIDS_OK);
+
+  std::vector<embedids_result_t> results(kDevices);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, kDevices, results.data()),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  for (uint32_t d = 0; d < kDevices; d++) {
+    bool anomalous = d == 7 || d == 512 || d == 900;
+    EXPECT_EQ(results[d] != EMBEDIDS_OK, anomalous) << "device " << d;
+  }
+
+  // A range that avoids the anomalous devices is clean
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 8, 500, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, kDevices + 1, nullptr),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+TEST_F(EmbedIDSFleetTest, RingsWrapPerDevice) {
+  InitFleet(2);
+  ASSERT_EQ(Add(0, 0, 95), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 2, nullptr), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  // Four more points push the spike out of device 0's four-point ring
+  for (uint32_t i = 0; i < 4; i++) {
+    ASSERT_EQ(Add(0, 0, 10), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 2, nullptr), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSFleetTest, ResetAndDisabledMetrics) {
+  InitFleet(2);
+  ASSERT_EQ(Add(1, 1, 500), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 1, 1, nullptr), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(embedids_fleet_reset_device(&fleet, 1), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 1, 1, nullptr), EMBEDIDS_OK);
+
+  ASSERT_EQ(Add(1, 1, 500), EMBEDIDS_OK);
+  schema[1].metric.enabled = false;
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 2, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(Add(1, 1, 5), EMBEDIDS_ERROR_METRIC_DISABLED);
+  EXPECT_EQ(Add(2, 0, 5), EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+// Fires on the second analysis of a device, counting calls in its state
+static embedids_result_t secondCall(const embedids_metric_t *metric, const void *config,
+                                    void *context) {
+  (void)metric;
+  (void)config;
+  uint32_t *calls = static_cast<uint32_t *>(context);
+  return ++*calls == 2 ? EMBEDIDS_ERROR_CUSTOM_DETECTION : EMBEDIDS_OK;
+}
+
+TEST_F(EmbedIDSFleetTest, DevicesKeepSeparateAlgorithmState) {
+  uint32_t initial_calls = 0;
+  memset(&schema[1].algorithms[0].config, 0, sizeof(schema[1].algorithms[0].config));
+  schema[1].algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  schema[1].algorithms[0].config.custom.function = secondCall;
+  schema[1].algorithm_state = &initial_calls;
+  schema[1].algorithm_state_size = sizeof(initial_calls);
+  InitFleet(3);
+
+  std::vector<embedids_result_t> results(3);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 1, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 3, results.data()),
+            EMBEDIDS_ERROR_CUSTOM_DETECTION);
+  EXPECT_EQ(results[0], EMBEDIDS_ERROR_CUSTOM_DETECTION);
+  EXPECT_EQ(results[1], EMBEDIDS_OK);
+  EXPECT_EQ(results[2], EMBEDIDS_OK);
+  EXPECT_EQ(initial_calls, 0u);
+
+  // Reset restarts the state from the schema's copy
+  ASSERT_EQ(embedids_fleet_reset_device(&fleet, 0), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 1, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 1, 2, results.data()),
+            EMBEDIDS_ERROR_CUSTOM_DETECTION);
+  EXPECT_EQ(results[1], EMBEDIDS_ERROR_CUSTOM_DETECTION);
+
+  // A context pointer of its own would be shared by every device
+  embedids_fleet_memory_t report;
+  schema[1].algorithms[0].config.custom.context = &initial_calls;
+  EXPECT_EQ(embedids_fleet_memory(schema, 2, 4, &report),
+            EMBEDIDS_ERROR_ALGORITHM_NOT_SUPPORTED);
+  schema[1].algorithms[0].config.custom.context = nullptr;
+  schema[1].algorithm_state_size = 0;
+  EXPECT_EQ(embedids_fleet_memory(schema, 2, 4, &report), EMBEDIDS_ERROR_CONFIG_INVALID);
+}
+
+TEST_F(EmbedIDSFleetTest, UninitializedFleetIsRejected) {
+  uint32_t index = 0;
+  EXPECT_EQ(embedids_fleet_find_metric(&fleet, "cpu", &index), EMBEDIDS_ERROR_NOT_INITIALIZED);
+  EXPECT_EQ(embedids_fleet_analyze(&fleet, 0, 0, nullptr), EMBEDIDS_ERROR_NOT_INITIALIZED);
+  EXPECT_EQ(Add(0, 0, 1), EMBEDIDS_ERROR_NOT_INITIALIZED);
+}
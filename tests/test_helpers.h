@@ -0,0 +1,24 @@
+#ifndef EMBEDIDS_TEST_HELPERS_H
+#define EMBEDIDS_TEST_HELPERS_H
+
+#include "embedids.h"
+#include <cstring>
+
+/**
+ * @brief Reset a metric configuration to an enabled metric with an empty ring
+ *
+ * history may be NULL for layouts whose buffers are assigned later, such as
+ * persistent stores, shared-memory segments and configuration blobs.
+ */
+inline void setupMetric(embedids_metric_config_t &config, embedids_metric_datapoint_t *history,
+                        const char *name, embedids_metric_type_t type,
+                        uint32_t history_size) {
+  memset(&config, 0, sizeof(config));
+  strncpy(config.metric.name, name, EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+  config.metric.type = type;
+  config.metric.enabled = true;
+  config.metric.history = history;
+  config.metric.max_history_size = history_size;
+}
+
+#endif // EMBEDIDS_TEST_HELPERS_H
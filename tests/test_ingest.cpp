@@ -0,0 +1,146 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+extern "C" {
+embedids_result_t ingest_generic_u32(const embedids_u32_handle_t *handle, uint32_t value,
+                                     uint64_t timestamp_ms);
+embedids_result_t ingest_generic_bool(embedids_bool_handle_t *handle, bool value,
+                                      uint64_t timestamp_ms);
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+embedids_result_t ingest_generic_f32(const embedids_f32_handle_t *handle, float value,
+                                     uint64_t timestamp_ms);
+#endif
+}
+
+/**
+ * @brief Test fixture for typed ingest
+ *
+ * Tests resolving typed handles, the type check done at resolution, and
+ * that typed adds behave like embedids_add_datapoint.
+ */
+class EmbedIDSIngestTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metrics[4];
+  embedids_metric_datapoint_t history[4][3];
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(metrics, 0, sizeof(metrics));
+    memset(history, 0, sizeof(history));
+    setupMetric(metrics[0], history[0], "packets", EMBEDIDS_METRIC_TYPE_UINT32, 3);
+    setupMetric(metrics[1], history[1], "tamper", EMBEDIDS_METRIC_TYPE_BOOL, 3);
+    setupMetric(metrics[2], history[2], "state", EMBEDIDS_METRIC_TYPE_ENUM, 3);
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+    setupMetric(metrics[3], history[3], "cpu", EMBEDIDS_METRIC_TYPE_PERCENTAGE, 3);
+#else
+    setupMetric(metrics[3], history[3], "bytes", EMBEDIDS_METRIC_TYPE_UINT64, 3);
+#endif
+
+    system_config.metrics = metrics;
+    system_config.max_metrics = 4;
+    system_config.num_active_metrics = 4;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  static void countHook(uint32_t metric_index, const embedids_metric_datapoint_t *datapoint,
+                        void *user_data) {
+    (void)datapoint;
+    static_cast<uint32_t *>(user_data)[metric_index]++;
+  }
+};
+
+// ============================================================================
+// Handle Resolution Tests
+// ============================================================================
+
+TEST_F(EmbedIDSIngestTest, HandleTypeIsCheckedOnce) {
+  embedids_u32_handle_t packets;
+  embedids_u64_handle_t wide;
+  embedids_enum_handle_t state;
+  EXPECT_EQ(embedids_get_u32_handle(&context, "packets", &packets), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_get_u64_handle(&context, "packets", &wide),
+            EMBEDIDS_ERROR_METRIC_TYPE_MISMATCH);
+  EXPECT_EQ(embedids_get_enum_handle(&context, "tamper", &state),
+            EMBEDIDS_ERROR_METRIC_TYPE_MISMATCH);
+  EXPECT_EQ(embedids_get_enum_handle(&context, "missing", &state),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  EXPECT_EQ(embedids_get_enum_handle(&context, "state", nullptr),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+
+  embedids_cleanup(&context);
+  EXPECT_EQ(embedids_get_u32_handle(&context, "packets", &packets),
+            EMBEDIDS_ERROR_NOT_INITIALIZED);
+}
+
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+TEST_F(EmbedIDSIngestTest, FloatHandleCoversFloatStorage) {
+  embedids_f32_handle_t cpu;
+  ASSERT_EQ(embedids_get_f32_handle(&context, "cpu", &cpu), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_get_f32_handle(&context, "packets", &cpu),
+            EMBEDIDS_ERROR_METRIC_TYPE_MISMATCH);
+
+  ASSERT_EQ(embedids_add_f32(&cpu, 42.5f, 1000), EMBEDIDS_OK);
+  ASSERT_EQ(ingest_generic_f32(&cpu, 43.5f, 2000), EMBEDIDS_OK);
+  EXPECT_FLOAT_EQ(history[3][0].value.f32, 42.5f);
+  EXPECT_FLOAT_EQ(history[3][1].value.f32, 43.5f);
+  EXPECT_EQ(metrics[3].metric.current_size, 2u);
+}
+#endif
+
+// ============================================================================
+// Typed Add Tests
+// ============================================================================
+
+TEST_F(EmbedIDSIngestTest, TypedAddMatchesAddDatapoint) {
+  embedids_u32_handle_t packets;
+  ASSERT_EQ(embedids_get_u32_handle(&context, "packets", &packets), EMBEDIDS_OK);
+
+  uint32_t hook_calls[4] = {0, 0, 0, 0};
+  ASSERT_EQ(embedids_set_datapoint_hook(&context, countHook, hook_calls), EMBEDIDS_OK);
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(embedids_add_u32(&packets, 100 + i, 1000 * (i + 1)), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(metrics[0].metric.current_size, 3u);
+  EXPECT_EQ(metrics[0].metric.write_index, 1u);
+  EXPECT_EQ(history[0][0].value.u32, 103u);
+  EXPECT_EQ(history[0][0].timestamp_ms, 4000u);
+  EXPECT_EQ(hook_calls[0], 4u);
+
+  embedids_metric_value_t value;
+  value.u32 = 200;
+  ASSERT_EQ(embedids_add_datapoint(&context, "packets", value, 5000), EMBEDIDS_OK);
+  EXPECT_EQ(history[0][1].value.u32, 200u);
+  EXPECT_EQ(metrics[0].metric.write_index, 2u);
+}
+
+TEST_F(EmbedIDSIngestTest, GenericAddSelectsByHandle) {
+  embedids_u32_handle_t packets;
+  embedids_bool_handle_t tamper;
+  embedids_enum_handle_t state;
+  ASSERT_EQ(embedids_get_u32_handle(&context, "packets", &packets), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_get_bool_handle(&context, "tamper", &tamper), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_get_enum_handle(&context, "state", &state), EMBEDIDS_OK);
+
+  EXPECT_EQ(ingest_generic_u32(&packets, 7, 1000), EMBEDIDS_OK);
+  EXPECT_EQ(ingest_generic_bool(&tamper, true, 1000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_add_enum(&state, 3, 1000), EMBEDIDS_OK);
+  EXPECT_EQ(history[0][0].value.u32, 7u);
+  EXPECT_TRUE(history[1][0].value.boolean);
+  EXPECT_EQ(history[2][0].value.enum_val, 3u);
+}
+
+TEST_F(EmbedIDSIngestTest, DisabledMetricRejectsTypedAdd) {
+  embedids_bool_handle_t tamper;
+  ASSERT_EQ(embedids_get_bool_handle(&context, "tamper", &tamper), EMBEDIDS_OK);
+  metrics[1].metric.enabled = false;
+  EXPECT_EQ(embedids_add_bool(&tamper, true, 1000), EMBEDIDS_ERROR_METRIC_DISABLED);
+  EXPECT_EQ(metrics[1].metric.current_size, 0u);
+}
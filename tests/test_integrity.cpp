@@ -0,0 +1,144 @@
+#include "embedids.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+extern "C" {
+uint32_t embedids_crc32c(uint32_t crc, const void *data, size_t len);
+uint32_t embedids_crc32c_portable(uint32_t crc, const void *data, size_t len);
+}
+
+/**
+ * @brief Test fixture for history integrity checksums
+ *
+ * Tests that block checksums follow the ring as it fills and wraps, and
+ * that changes made behind the library's back are reported on analysis
+ * and on demand.
+ */
+class EmbedIDSIntegrityTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kPoints = EMBEDIDS_INTEGRITY_BLOCK_POINTS * 2 + 3;
+
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history[kPoints];
+  uint32_t block_crcs[EMBEDIDS_INTEGRITY_BLOCKS(kPoints)];
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(&metric_config, 0, sizeof(metric_config));
+    memset(history, 0, sizeof(history));
+    strncpy(metric_config.metric.name, "syscalls", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_config.metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_config.metric.history = history;
+    metric_config.metric.block_crcs = block_crcs;
+    metric_config.metric.max_history_size = kPoints;
+    metric_config.metric.enabled = true;
+
+    system_config.metrics = &metric_config;
+    system_config.max_metrics = 1;
+    system_config.num_active_metrics = 1;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  void addPoints(uint32_t count) {
+    embedids_metric_value_t value;
+    for (uint32_t i = 0; i < count; ++i) {
+      value.u32 = i;
+      ASSERT_EQ(embedids_add_datapoint(&context, "syscalls", value, 1000 + i), EMBEDIDS_OK);
+    }
+  }
+};
+
+// ============================================================================
+// Checksum Tests
+// ============================================================================
+
+TEST_F(EmbedIDSIntegrityTest, AcceleratedCrcMatchesPortable) {
+  const char *check = "123456789";
+  EXPECT_EQ(embedids_crc32c_portable(0, check, 9), 0xe3069283u);
+  EXPECT_EQ(embedids_crc32c(0, check, 9), 0xe3069283u);
+
+  uint8_t data[67];
+  for (size_t i = 0; i < sizeof(data); ++i) {
+    data[i] = (uint8_t)(i * 37 + 11);
+  }
+  for (size_t len = 0; len <= sizeof(data); len += 5) {
+    uint32_t expected = embedids_crc32c_portable(0, data, len);
+    EXPECT_EQ(embedids_crc32c(0, data, len), expected);
+    EXPECT_EQ(embedids_crc32c(embedids_crc32c(0, data, len / 2), data + len / 2,
+                              len - len / 2),
+              expected);
+  }
+}
+
+TEST_F(EmbedIDSIntegrityTest, ChecksumsFollowFillAndWrap) {
+  for (uint32_t total = 0; total < kPoints * 2 + 5; total += 7) {
+    EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_OK) << total;
+    addPoints(7);
+  }
+  EXPECT_EQ(embedids_verify_history(&context, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+}
+
+// ============================================================================
+// Tamper Detection Tests
+// ============================================================================
+
+TEST_F(EmbedIDSIntegrityTest, RewrittenHistoryIsReported) {
+  addPoints(kPoints + 4);
+  history[EMBEDIDS_INTEGRITY_BLOCK_POINTS + 1].value.u32 ^= 0x80;
+
+  EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  EXPECT_EQ(embedids_analyze_metric(&context, "syscalls"), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  embedids_detection_t detection;
+  EXPECT_EQ(embedids_analyze_metric_detailed(&context, "syscalls", &detection),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  EXPECT_EQ(detection.severity, EMBEDIDS_SEVERITY_CRITICAL);
+  EXPECT_EQ(detection.algorithm, EMBEDIDS_NO_INDEX);
+
+  // Accepting the change explicitly makes the history valid again
+  ASSERT_EQ(embedids_reseal_history(&context, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "syscalls"), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSIntegrityTest, TamperInPartialBlockIsReported) {
+  addPoints(3);
+  history[1].timestamp_ms = 1;
+  EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  // Slots not yet written are outside every checksum
+  ASSERT_EQ(embedids_reseal_history(&context, "syscalls"), EMBEDIDS_OK);
+  history[kPoints - 1].value.u32 = 99;
+  EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSIntegrityTest, TamperInStaleTailIsReported) {
+  // Full ring, write_index three points into block 0
+  addPoints(kPoints + 3);
+  for (uint32_t i = 3; i < EMBEDIDS_INTEGRITY_BLOCK_POINTS; ++i) {
+    history[i].value.u32 ^= 0x80;
+    EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_ERROR_BUFFER_CORRUPT) << i;
+    history[i].value.u32 ^= 0x80;
+    EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_OK) << i;
+  }
+
+  // A reseal mid-block keeps the tail covered as the block refills
+  ASSERT_EQ(embedids_reseal_history(&context, "syscalls"), EMBEDIDS_OK);
+  addPoints(2);
+  history[EMBEDIDS_INTEGRITY_BLOCK_POINTS - 1].timestamp_ms = 1;
+  EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSIntegrityTest, MetricsWithoutChecksumsAlwaysPass) {
+  metric_config.metric.block_crcs = nullptr;
+  addPoints(5);
+  history[2].value.u32 = 12345;
+  EXPECT_EQ(embedids_verify_history(&context, "syscalls"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_verify_history(&context, "missing"), EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+}
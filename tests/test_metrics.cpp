@@ -224,6 +224,83 @@ TEST_F(EmbedIDSMetricsTest, MetricResetFunctionality) {
   EXPECT_EQ(result, EMBEDIDS_OK);
 }
 
+TEST_F(EmbedIDSMetricsTest, ResetHidesPointsWithoutClearingThem) {
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "rx_bytes", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 1234;
+  ASSERT_EQ(embedids_add_datapoint(&context, "rx_bytes", value, 1000), EMBEDIDS_OK);
+  uint32_t epoch = context.epoch;
+
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_EQ(context.epoch, epoch + 1);
+  EXPECT_EQ(metric_config.metric.current_size, 0u);
+  EXPECT_EQ(metric_config.metric.write_index, 0u);
+  EXPECT_EQ(history_buffer[0].value.u32, 1234u); // Left in place, just invisible
+
+  embedids_metric_summary_t summary;
+  EXPECT_EQ(embedids_get_summary(&context, "rx_bytes", &summary), EMBEDIDS_OK);
+  EXPECT_EQ(summary.count, 0u);
+}
+
+TEST_F(EmbedIDSMetricsTest, EpochChangesOnlyWhenHistoryIsDiscarded) {
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "rx_bytes", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  uint32_t epoch = 0;
+  EXPECT_EQ(embedids_get_epoch(&context, &epoch), EMBEDIDS_ERROR_NOT_INITIALIZED);
+  context.epoch = 0xdeadbeef; // Whatever an unzeroed context holds
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_get_epoch(&context, nullptr), EMBEDIDS_ERROR_INVALID_PARAM);
+
+  uint32_t before = 1;
+  ASSERT_EQ(embedids_get_epoch(&context, &before), EMBEDIDS_OK);
+  EXPECT_EQ(before, 0u);
+  embedids_metric_value_t value;
+  value.u32 = 7;
+  ASSERT_EQ(embedids_add_datapoint(&context, "rx_bytes", value, 1000), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_get_epoch(&context, &epoch), EMBEDIDS_OK);
+  EXPECT_EQ(epoch, before);
+
+  ASSERT_EQ(embedids_reset_prefix(&context, "rx_bytes"), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_get_epoch(&context, &epoch), EMBEDIDS_OK);
+  EXPECT_NE(epoch, before);
+}
+
+TEST_F(EmbedIDSMetricsTest, WipeOverwritesStoredPoints) {
+  embedids_metric_datapoint_t history_buffer[4];
+  uint32_t block_crcs[EMBEDIDS_INTEGRITY_BLOCKS(4)];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "location", EMBEDIDS_METRIC_TYPE_UINT64, 4);
+  metric_config.metric.block_crcs = block_crcs;
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u64 = 0x1122334455667788ull;
+  for (uint64_t t = 0; t < 6; t++) {
+    ASSERT_EQ(embedids_add_datapoint(&context, "location", value, t), EMBEDIDS_OK);
+  }
+
+  EXPECT_EQ(embedids_wipe_history(&context, "missing"), EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  uint32_t epoch = context.epoch;
+  ASSERT_EQ(embedids_wipe_history(&context, "location"), EMBEDIDS_OK);
+  EXPECT_EQ(context.epoch, epoch + 1);
+  EXPECT_EQ(metric_config.metric.current_size, 0u);
+  for (const embedids_metric_datapoint_t &point : history_buffer) {
+    EXPECT_EQ(point.value.u64, 0u);
+    EXPECT_EQ(point.timestamp_ms, 0u);
+  }
+
+  // The wiped metric keeps working and its checksums stay consistent
+  ASSERT_EQ(embedids_add_datapoint(&context, "location", value, 10), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_verify_history(&context, nullptr), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_wipe_history(&context, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(history_buffer[0].value.u64, 0u);
+}
+
 // ============================================================================
 // Metric Buffer Management Tests
 // ============================================================================
@@ -300,3 +377,74 @@ TEST_F(EmbedIDSMetricsTest, DisabledMetricBehavior) {
   // The exact behavior depends on implementation
   EXPECT_TRUE(result == EMBEDIDS_OK || result == EMBEDIDS_ERROR_METRIC_DISABLED);
 }
+
+// ============================================================================
+// History Window Tests
+// ============================================================================
+
+TEST_F(EmbedIDSMetricsTest, WindowFollowsRingWraparound) {
+  embedids_metric_datapoint_t history_buffer[5];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "window", EMBEDIDS_METRIC_TYPE_UINT32, 5);
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  embedids_datapoint_span_t view;
+  ASSERT_EQ(embedids_metric_window(&metric_config.metric, 3, &view), EMBEDIDS_OK);
+  EXPECT_EQ(EMBEDIDS_SPAN_COUNT(&view), 0u);
+  EXPECT_EQ(embedids_span_begin(&view), nullptr);
+
+  embedids_u32_handle_t handle;
+  ASSERT_EQ(embedids_get_u32_handle(&context, "window", &handle), EMBEDIDS_OK);
+  for (uint32_t v = 1; v <= 7; v++) {
+    ASSERT_EQ(embedids_add_u32(&handle, v, v), EMBEDIDS_OK);
+  }
+
+  // Ring holds 3 4 5 | 6 7 with write_index 2: the last four wrap
+  ASSERT_EQ(embedids_get_window(&handle.handle, 4, &view), EMBEDIDS_OK);
+  EXPECT_EQ(view.first, &history_buffer[3]);
+  EXPECT_EQ(view.first_count, 2u);
+  EXPECT_EQ(view.second, &history_buffer[0]);
+  EXPECT_EQ(view.second_count, 2u);
+
+  uint32_t expected = 4;
+  EMBEDIDS_SPAN_FOREACH(&view, point) {
+    EXPECT_EQ(point->value.u32, expected++);
+  }
+  EXPECT_EQ(expected, 8u);
+  EXPECT_EQ(EMBEDIDS_SPAN_AT(&view, 2)->value.u32, 6u);
+  EXPECT_EQ(EMBEDIDS_SPAN_NEWEST(&view)->value.u32, 7u);
+
+  // The last two do not wrap
+  ASSERT_EQ(embedids_get_window(&handle.handle, 2, &view), EMBEDIDS_OK);
+  EXPECT_EQ(view.first, &history_buffer[0]);
+  EXPECT_EQ(view.first_count, 2u);
+  EXPECT_EQ(view.second, nullptr);
+
+  // Requests beyond the stored points are clamped
+  ASSERT_EQ(embedids_get_window(&handle.handle, 100, &view), EMBEDIDS_OK);
+  EXPECT_EQ(EMBEDIDS_SPAN_COUNT(&view), 5u);
+  EXPECT_EQ(embedids_span_begin(&view)->value.u32, 3u);
+}
+
+TEST_F(EmbedIDSMetricsTest, WindowEndingAtRingEnd) {
+  embedids_metric_datapoint_t history_buffer[4];
+  embedids_metric_config_t metric_config;
+  setupBasicMetric(metric_config, history_buffer, "window", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  ASSERT_EQ(initializeWithMetric(&metric_config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  for (uint32_t v = 1; v <= 4; v++) {
+    value.u32 = v;
+    ASSERT_EQ(embedids_add_datapoint(&context, "window", value, v), EMBEDIDS_OK);
+  }
+
+  // write_index is back at 0, the case naive (write_index - 1) gets wrong
+  embedids_datapoint_span_t view;
+  ASSERT_EQ(embedids_metric_window(&metric_config.metric, 1, &view), EMBEDIDS_OK);
+  EXPECT_EQ(view.first, &history_buffer[3]);
+  EXPECT_EQ(view.second, nullptr);
+  EXPECT_EQ(EMBEDIDS_SPAN_NEWEST(&view)->value.u32, 4u);
+
+  EXPECT_EQ(embedids_metric_window(nullptr, 1, &view), EMBEDIDS_ERROR_INVALID_PARAM);
+  EXPECT_EQ(embedids_get_window(nullptr, 1, &view), EMBEDIDS_ERROR_INVALID_PARAM);
+}
@@ -0,0 +1,138 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for hierarchical metric namespaces
+ *
+ * Tests prefix matching on '.' boundaries, bulk enable/disable, analysis
+ * and reset of a subtree, and that the name order follows registration
+ * and removal.
+ */
+class EmbedIDSNamespaceTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kMetrics = 7;
+
+  embedids_context_t context;
+  embedids_metric_config_t metric_configs[kMetrics + 1];
+  embedids_metric_datapoint_t histories[kMetrics + 1][4];
+  embedids_system_config_t system_config;
+
+  void SetUp() override {
+    // Deliberately unsorted so init has to order them
+    const char *names[kMetrics] = {"proc.1234.mem", "net.eth0.tx_pps",
+                                   "net.eth01.rx_pps", "proc.12345.cpu",
+                                   "net.eth0",        "proc.1234.cpu",
+                                   "net.eth0.rx_pps"};
+
+    memset(&context, 0, sizeof(context));
+    memset(metric_configs, 0, sizeof(metric_configs));
+    for (uint32_t i = 0; i < kMetrics; i++) {
+      setupMetric(metric_configs[i], histories[i], names[i], EMBEDIDS_METRIC_TYPE_UINT32, 4);
+    }
+
+    // Threshold on proc.1234.mem for subtree analysis
+    metric_configs[0].num_algorithms = 1;
+    metric_configs[0].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    metric_configs[0].algorithms[0].enabled = true;
+    metric_configs[0].algorithms[0].config.threshold.max_threshold.u32 = 100;
+    metric_configs[0].algorithms[0].config.threshold.check_max = true;
+
+    memset(&system_config, 0, sizeof(system_config));
+    system_config.metrics = metric_configs;
+    system_config.max_metrics = kMetrics + 1;
+    system_config.num_active_metrics = kMetrics;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  bool isEnabled(const char *name) {
+    for (uint32_t i = 0; i < system_config.num_active_metrics; i++) {
+      if (strcmp(metric_configs[i].metric.name, name) == 0) {
+        return metric_configs[i].metric.enabled;
+      }
+    }
+    return false;
+  }
+};
+
+// ============================================================================
+// Prefix Matching Tests
+// ============================================================================
+
+TEST_F(EmbedIDSNamespaceTest, PrefixMatchesSegmentBoundaries) {
+  uint32_t count = 0;
+  ASSERT_EQ(embedids_set_enabled_prefix(&context, "net.eth0", false, &count),
+            EMBEDIDS_OK);
+  EXPECT_EQ(count, 3u);
+  EXPECT_FALSE(isEnabled("net.eth0"));
+  EXPECT_FALSE(isEnabled("net.eth0.rx_pps"));
+  EXPECT_FALSE(isEnabled("net.eth0.tx_pps"));
+  EXPECT_TRUE(isEnabled("net.eth01.rx_pps"));
+
+  // A trailing separator means the same subtree
+  ASSERT_EQ(embedids_set_enabled_prefix(&context, "net.eth0.", true, &count),
+            EMBEDIDS_OK);
+  EXPECT_EQ(count, 3u);
+  EXPECT_TRUE(isEnabled("net.eth0"));
+
+  ASSERT_EQ(embedids_set_enabled_prefix(&context, "proc.1234", false, &count),
+            EMBEDIDS_OK);
+  EXPECT_EQ(count, 2u);
+  EXPECT_TRUE(isEnabled("proc.12345.cpu"));
+
+  ASSERT_EQ(embedids_set_enabled_prefix(&context, "", true, &count), EMBEDIDS_OK);
+  EXPECT_EQ(count, kMetrics);
+}
+
+TEST_F(EmbedIDSNamespaceTest, UnknownPrefixIsNotFound) {
+  uint32_t count = 99;
+  EXPECT_EQ(embedids_set_enabled_prefix(&context, "net.eth", false, &count),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  EXPECT_EQ(count, 0u);
+  EXPECT_EQ(embedids_analyze_prefix(&context, "disk"),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  EXPECT_EQ(embedids_analyze_prefix(&context, nullptr),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+}
+
+// ============================================================================
+// Subtree Operation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSNamespaceTest, AnalyzeAndResetSubtree) {
+  embedids_metric_value_t value;
+  value.u32 = 500;
+  ASSERT_EQ(embedids_add_datapoint(&context, "proc.1234.mem", value, 1000),
+            EMBEDIDS_OK);
+
+  EXPECT_EQ(embedids_analyze_prefix(&context, "net"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_prefix(&context, "proc.12345"), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_prefix(&context, "proc"),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+
+  // Disabled metrics are skipped, as in embedids_analyze_all
+  ASSERT_EQ(embedids_set_enabled_prefix(&context, "proc.1234.mem", false, nullptr),
+            EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_prefix(&context, "proc"), EMBEDIDS_OK);
+
+  ASSERT_EQ(embedids_reset_prefix(&context, "proc.1234"), EMBEDIDS_OK);
+  EXPECT_EQ(metric_configs[0].metric.current_size, 0u);
+}
+
+TEST_F(EmbedIDSNamespaceTest, RegistrationUpdatesOrder) {
+  ASSERT_EQ(embedids_unregister_metric(&context, "net.eth0.tx_pps"), EMBEDIDS_OK);
+
+  embedids_metric_config_t config;
+  setupMetric(config, histories[kMetrics], "net.eth0.errors", EMBEDIDS_METRIC_TYPE_UINT32, 4);
+  ASSERT_EQ(embedids_register_metric(&context, &config, nullptr), EMBEDIDS_OK);
+
+  uint32_t count = 0;
+  ASSERT_EQ(embedids_set_enabled_prefix(&context, "net.eth0", false, &count),
+            EMBEDIDS_OK);
+  EXPECT_EQ(count, 3u);
+  EXPECT_FALSE(isEnabled("net.eth0.errors"));
+  EXPECT_TRUE(isEnabled("net.eth01.rx_pps"));
+}
@@ -0,0 +1,152 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+/**
+ * @brief Test fixture for mmap-backed persistent history
+ *
+ * Tests creating a store, reattaching after an unmap (simulated restart)
+ * and rejecting files that do not match the expected metrics.
+ */
+class EmbedIDSPersistTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_metric_config_t layout[2];
+  FILE *file = nullptr;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(layout, 0, sizeof(layout));
+    setupMetric(layout[0], nullptr, "cpu_usage", EMBEDIDS_METRIC_TYPE_FLOAT, 4);
+    setupMetric(layout[1], nullptr, "open_files", EMBEDIDS_METRIC_TYPE_UINT32, 6);
+
+    // Threshold on open_files so reattached algorithms can be checked
+    layout[1].num_algorithms = 1;
+    layout[1].algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    layout[1].algorithms[0].enabled = true;
+    layout[1].algorithms[0].config.threshold.max_threshold.u32 = 100;
+    layout[1].algorithms[0].config.threshold.check_max = true;
+
+    file = tmpfile();
+    ASSERT_NE(file, nullptr);
+  }
+
+  void TearDown() override {
+    embedids_cleanup(&context);
+    if (file) {
+      fclose(file);
+    }
+  }
+};
+
+// ============================================================================
+// Create and Reattach Tests
+// ============================================================================
+
+TEST_F(EmbedIDSPersistTest, ReattachContinuesWhereItLeftOff) {
+  embedids_persist_t store;
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  EXPECT_FALSE(store.reattached);
+  ASSERT_EQ(embedids_init(&context, &store.config), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < 8; i++) {
+    value.u32 = 10 * i;
+    ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, i), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(embedids_persist_sync(&store, true), EMBEDIDS_OK);
+  embedids_cleanup(&context);
+  embedids_persist_close(&store);
+
+  // Restart: same file, fresh mapping
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  EXPECT_TRUE(store.reattached);
+  ASSERT_EQ(embedids_init(&context, &store.config), EMBEDIDS_OK);
+
+  const embedids_metric_t *metric = &store.config.metrics[1].metric;
+  EXPECT_EQ(metric->current_size, 6u);
+  EXPECT_EQ(metric->write_index, 2u);
+  EXPECT_EQ(metric->history[1].value.u32, 70u);
+  EXPECT_EQ(store.config.metrics[0].metric.current_size, 0u);
+
+  // Algorithms come from the layout and run on the reattached ring
+  value.u32 = 500;
+  ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, 9), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_analyze_metric(&context, "open_files"),
+            EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  embedids_persist_close(&store);
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSPersistTest, RejectsDifferentMetrics) {
+  embedids_persist_t store;
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  embedids_persist_close(&store);
+
+  layout[0].metric.type = EMBEDIDS_METRIC_TYPE_UINT64;
+  EXPECT_EQ(embedids_persist_open(&store, fileno(file), layout, 2),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  layout[0].metric.type = EMBEDIDS_METRIC_TYPE_FLOAT;
+  layout[0].metric.max_history_size = 5;
+  EXPECT_EQ(embedids_persist_open(&store, fileno(file), layout, 2),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSPersistTest, RejectsCorruptRingIndices) {
+  embedids_persist_t store;
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  store.config.metrics[0].metric.write_index = 99;
+  embedids_persist_close(&store);
+
+  EXPECT_EQ(embedids_persist_open(&store, fileno(file), layout, 2),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSPersistTest, ReattachCompletesTornCommit) {
+  embedids_persist_t store;
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_init(&context, &store.config), EMBEDIDS_OK);
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < 3; i++) {
+    value.u32 = i;
+    ASSERT_EQ(embedids_add_datapoint(&context, "open_files", value, i), EMBEDIDS_OK);
+  }
+  embedids_cleanup(&context);
+
+  // Crash after write_index moved but before current_size followed
+  store.config.metrics[1].metric.current_size = 2;
+  // Same on the point that fills the ring
+  store.config.metrics[0].metric.current_size = 3;
+  store.config.metrics[0].metric.write_index = 0;
+  embedids_persist_close(&store);
+
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  EXPECT_EQ(store.config.metrics[1].metric.current_size, 3u);
+  EXPECT_EQ(store.config.metrics[1].metric.write_index, 3u);
+  EXPECT_EQ(store.config.metrics[0].metric.current_size, 4u);
+  EXPECT_EQ(store.config.metrics[0].metric.write_index, 0u);
+  store.config.metrics[1].metric.current_size = 1;
+  embedids_persist_close(&store);
+
+  // Anything further apart is still corrupt
+  EXPECT_EQ(embedids_persist_open(&store, fileno(file), layout, 2),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSPersistTest, RequiredSizeMatchesFile) {
+  size_t size = 0;
+  ASSERT_EQ(embedids_persist_required_size(layout, 2, &size), EMBEDIDS_OK);
+
+  embedids_persist_t store;
+  ASSERT_EQ(embedids_persist_open(&store, fileno(file), layout, 2), EMBEDIDS_OK);
+  EXPECT_EQ(store.size, size);
+  EXPECT_EQ((uintptr_t)store.config.metrics[0].metric.history % 64, 0u);
+  embedids_persist_close(&store);
+}
@@ -0,0 +1,224 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @brief Test fixture for time-range aggregate queries
+ *
+ * Tests that a metric with a range index and one without give the same
+ * answers as a plain walk over the stored points, as the ring fills,
+ * wraps, resets and is rewritten behind the library's back.
+ */
+class EmbedIDSRangeTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kPoints = 13; // Not a power of two on purpose
+
+  struct Point {
+    uint64_t timestamp_ms;
+    uint32_t value;
+  };
+
+  embedids_context_t context;
+  embedids_system_config_t system_config;
+  embedids_metric_config_t metric_configs[2];
+  embedids_metric_datapoint_t indexed_history[kPoints];
+  embedids_metric_datapoint_t plain_history[kPoints];
+  embedids_range_aggregate_t range_index[EMBEDIDS_RANGE_INDEX_NODES(kPoints)];
+  std::vector<Point> added;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(&system_config, 0, sizeof(system_config));
+    memset(metric_configs, 0, sizeof(metric_configs));
+    memset(indexed_history, 0, sizeof(indexed_history));
+    memset(plain_history, 0, sizeof(plain_history));
+
+    setupMetric(metric_configs[0], indexed_history, "indexed", EMBEDIDS_METRIC_TYPE_UINT32,
+                kPoints);
+    metric_configs[0].metric.range_index = range_index;
+    setupMetric(metric_configs[1], plain_history, "plain", EMBEDIDS_METRIC_TYPE_UINT32, kPoints);
+
+    system_config.metrics = metric_configs;
+    system_config.max_metrics = 2;
+    system_config.num_active_metrics = 2;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  void addPoint(uint64_t timestamp_ms, uint32_t value) {
+    embedids_metric_value_t v;
+    v.u32 = value;
+    ASSERT_EQ(embedids_add_datapoint(&context, "indexed", v, timestamp_ms), EMBEDIDS_OK);
+    ASSERT_EQ(embedids_add_datapoint(&context, "plain", v, timestamp_ms), EMBEDIDS_OK);
+    added.push_back({timestamp_ms, value});
+  }
+
+  // Aggregate of the points still held, computed the slow way
+  embedids_range_aggregate_t expected(uint64_t from_ms, uint64_t to_ms) const {
+    embedids_range_aggregate_t result;
+    memset(&result, 0, sizeof(result));
+    size_t start = added.size() > kPoints ? added.size() - kPoints : 0;
+    for (size_t i = start; i < added.size(); ++i) {
+      const Point &p = added[i];
+      if (p.timestamp_ms < from_ms || p.timestamp_ms > to_ms) {
+        continue;
+      }
+      if (result.count == 0 || p.value < result.min.u32) {
+        result.min.u32 = p.value;
+      }
+      if (result.count == 0 || p.value > result.max.u32) {
+        result.max.u32 = p.value;
+      }
+      result.sum += (float)p.value;
+      result.count++;
+    }
+    return result;
+  }
+
+  void expectAllRangesMatch() {
+    uint64_t last = added.empty() ? 0 : added.back().timestamp_ms + 2;
+    for (uint64_t from = 0; from <= last; from += 3) {
+      for (uint64_t to = from; to <= last; to += 2) {
+        embedids_range_aggregate_t want = expected(from, to);
+        for (const char *name : {"indexed", "plain"}) {
+          embedids_range_aggregate_t got;
+          ASSERT_EQ(embedids_query_range(&context, name, from, to, &got), EMBEDIDS_OK);
+          ASSERT_EQ(got.count, want.count) << name << " [" << from << ", " << to << "]";
+          if (want.count == 0) {
+            continue;
+          }
+          EXPECT_EQ(got.min.u32, want.min.u32) << name;
+          EXPECT_EQ(got.max.u32, want.max.u32) << name;
+          EXPECT_FLOAT_EQ(got.sum, want.sum) << name;
+        }
+      }
+    }
+  }
+};
+
+// ============================================================================
+// Query Tests
+// ============================================================================
+
+TEST_F(EmbedIDSRangeTest, IndexMatchesScanAsRingWraps) {
+  uint64_t timestamp = 10;
+  for (uint32_t i = 0; i < kPoints * 3; ++i) {
+    // Repeated timestamps and a value pattern that moves min and max around
+    timestamp += (i % 4 == 0) ? 0 : 3;
+    addPoint(timestamp, (i * 37 + 11) % 101);
+    if (i % 5 == 0 || i == kPoints - 1 || i == kPoints) {
+      expectAllRangesMatch();
+    }
+  }
+  expectAllRangesMatch();
+}
+
+TEST_F(EmbedIDSRangeTest, BoundsAreInclusive) {
+  addPoint(100, 5);
+  addPoint(200, 9);
+  addPoint(300, 1);
+
+  embedids_range_aggregate_t got;
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 200, 200, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 1u);
+  EXPECT_EQ(got.max.u32, 9u);
+
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 100, 300, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 3u);
+  EXPECT_EQ(got.min.u32, 1u);
+  EXPECT_EQ(got.max.u32, 9u);
+  EXPECT_FLOAT_EQ(got.sum, 15.0f);
+
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 301, 1000, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 0u);
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 0, 99, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 0u);
+}
+
+TEST_F(EmbedIDSRangeTest, InvalidQueriesAreRejected) {
+  embedids_range_aggregate_t got;
+  EXPECT_EQ(embedids_query_range(&context, "indexed", 5, 4, &got), EMBEDIDS_ERROR_INVALID_PARAM);
+  EXPECT_EQ(embedids_query_range(&context, "indexed", 0, 4, nullptr),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+  EXPECT_EQ(embedids_query_range(&context, "memory", 0, 4, &got),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 0, UINT64_MAX, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 0u);
+
+  embedids_cleanup(&context);
+  EXPECT_EQ(embedids_query_range(&context, "indexed", 0, 4, &got),
+            EMBEDIDS_ERROR_NOT_INITIALIZED);
+}
+
+// ============================================================================
+// Index Maintenance Tests
+// ============================================================================
+
+TEST_F(EmbedIDSRangeTest, ResetLeavesNoStaleAggregates) {
+  for (uint32_t i = 0; i < kPoints + 4; ++i) {
+    addPoint(100 + i, 1000 + i);
+  }
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  added.clear();
+
+  addPoint(500, 3);
+  addPoint(501, 7);
+  expectAllRangesMatch();
+
+  embedids_range_aggregate_t got;
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 0, UINT64_MAX, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 2u);
+  EXPECT_EQ(got.max.u32, 7u);
+
+  // Wiping clears the index along with the points
+  ASSERT_EQ(embedids_wipe_history(&context, "indexed"), EMBEDIDS_OK);
+  for (const embedids_range_aggregate_t &node : range_index) {
+    EXPECT_EQ(node.count, 0u);
+  }
+}
+
+TEST_F(EmbedIDSRangeTest, IndexRebuiltFromExistingHistory) {
+  for (uint32_t i = 0; i < kPoints + 6; ++i) {
+    addPoint(10 * i, i % 7);
+  }
+
+  // Rewrite one stored point behind the library's back, then reseal
+  uint32_t slot = (metric_configs[0].metric.write_index + 2) % kPoints;
+  indexed_history[slot].value.u32 = 500;
+  plain_history[slot].value.u32 = 500;
+  added[added.size() - kPoints + 2].value = 500;
+  ASSERT_EQ(embedids_reseal_history(&context, nullptr), EMBEDIDS_OK);
+  expectAllRangesMatch();
+
+  // A fresh context over the same rings builds its index at init
+  embedids_cleanup(&context);
+  memset(range_index, 0xA5, sizeof(range_index));
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  expectAllRangesMatch();
+}
+
+TEST_F(EmbedIDSRangeTest, FloatMetricAggregates) {
+  embedids_cleanup(&context);
+  metric_configs[0].metric.type = EMBEDIDS_METRIC_TYPE_FLOAT;
+  metric_configs[0].metric.current_size = 0;
+  metric_configs[0].metric.write_index = 0;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  const float values[] = {1.5f, -2.25f, 8.0f, 0.5f};
+  for (uint32_t i = 0; i < 4; ++i) {
+    embedids_metric_value_t v;
+    v.f32 = values[i];
+    ASSERT_EQ(embedids_add_datapoint(&context, "indexed", v, 1000 + i), EMBEDIDS_OK);
+  }
+
+  embedids_range_aggregate_t got;
+  ASSERT_EQ(embedids_query_range(&context, "indexed", 1001, 1003, &got), EMBEDIDS_OK);
+  EXPECT_EQ(got.count, 3u);
+  EXPECT_FLOAT_EQ(got.min.f32, -2.25f);
+  EXPECT_FLOAT_EQ(got.max.f32, 8.0f);
+  EXPECT_FLOAT_EQ(got.sum, 6.25f);
+}
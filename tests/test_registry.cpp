@@ -0,0 +1,170 @@
+#include "embedids.h"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test fixture for runtime metric registration and removal
+ *
+ * Tests registering into spare capacity, slot reuse after removal, the
+ * name index staying consistent through churn, and rejection of
+ * duplicate, oversized and over-capacity registrations.
+ */
+class EmbedIDSRegistryTest : public ::testing::Test {
+protected:
+  static constexpr uint32_t kSlots = 8;
+
+  embedids_context_t context;
+  embedids_metric_config_t metric_configs[kSlots];
+  embedids_metric_datapoint_t histories[kSlots][4];
+  embedids_system_config_t system_config;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(metric_configs, 0, sizeof(metric_configs));
+    memset(&system_config, 0, sizeof(system_config));
+    system_config.metrics = metric_configs;
+    system_config.max_metrics = kSlots;
+    system_config.num_active_metrics = 0;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  embedids_metric_config_t makeMetric(const char *name, uint32_t buffer) {
+    embedids_metric_config_t config;
+    memset(&config, 0, sizeof(config));
+    strncpy(config.metric.name, name, EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    config.metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    config.metric.enabled = true;
+    config.metric.history = histories[buffer];
+    config.metric.max_history_size = 4;
+    return config;
+  }
+
+  embedids_result_t addValue(const char *name, uint32_t v) {
+    embedids_metric_value_t value;
+    value.u32 = v;
+    return embedids_add_datapoint(&context, name, value, 1000);
+  }
+};
+
+// ============================================================================
+// Registration Tests
+// ============================================================================
+
+TEST_F(EmbedIDSRegistryTest, RegisterIntoSpareCapacity) {
+  embedids_metric_config_t config = makeMetric("container_a.cpu", 0);
+  uint32_t slot = 99;
+  ASSERT_EQ(embedids_register_metric(&context, &config, &slot), EMBEDIDS_OK);
+  EXPECT_EQ(slot, 0u);
+  EXPECT_EQ(system_config.num_active_metrics, 1u);
+
+  EXPECT_EQ(addValue("container_a.cpu", 42), EMBEDIDS_OK);
+  EXPECT_EQ(metric_configs[0].metric.current_size, 1u);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSRegistryTest, UnregisterReleasesSlotForReuse) {
+  uint32_t slot = 0;
+  for (uint32_t i = 0; i < 3; i++) {
+    char name[16];
+    snprintf(name, sizeof(name), "proc_%u", i);
+    embedids_metric_config_t config = makeMetric(name, i);
+    ASSERT_EQ(embedids_register_metric(&context, &config, &slot), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(addValue("proc_1", 7), EMBEDIDS_OK);
+
+  ASSERT_EQ(embedids_unregister_metric(&context, "proc_1"), EMBEDIDS_OK);
+  EXPECT_EQ(addValue("proc_1", 7), EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  EXPECT_EQ(embedids_unregister_metric(&context, "proc_1"),
+            EMBEDIDS_ERROR_METRIC_NOT_FOUND);
+  EXPECT_EQ(embedids_analyze_all(&context), EMBEDIDS_OK);
+
+  // The released slot is reused before the array grows, with fresh history
+  embedids_metric_config_t config = makeMetric("proc_3", 1);
+  ASSERT_EQ(embedids_register_metric(&context, &config, &slot), EMBEDIDS_OK);
+  EXPECT_EQ(slot, 1u);
+  EXPECT_EQ(system_config.num_active_metrics, 3u);
+  EXPECT_EQ(metric_configs[1].metric.current_size, 0u);
+  EXPECT_EQ(addValue("proc_0", 1), EMBEDIDS_OK);
+  EXPECT_EQ(addValue("proc_2", 2), EMBEDIDS_OK);
+  EXPECT_EQ(addValue("proc_3", 3), EMBEDIDS_OK);
+}
+
+TEST_F(EmbedIDSRegistryTest, InitIndexesExistingMetricsAndFreeSlots) {
+  embedids_cleanup(&context);
+  metric_configs[0] = makeMetric("static_a", 0);
+  metric_configs[2] = makeMetric("static_b", 2);
+  system_config.num_active_metrics = 3;
+  ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+  EXPECT_EQ(addValue("static_b", 1), EMBEDIDS_OK);
+  embedids_metric_config_t config = makeMetric("dynamic", 1);
+  uint32_t slot = 0;
+  ASSERT_EQ(embedids_register_metric(&context, &config, &slot), EMBEDIDS_OK);
+  EXPECT_EQ(slot, 1u);
+}
+
+// ============================================================================
+// Name Index Consistency Tests
+// ============================================================================
+
+TEST_F(EmbedIDSRegistryTest, IndexSurvivesChurn) {
+  // Register and remove in an interleaved order so probe chains get holes
+  bool live[kSlots * 4] = {};
+  char name[16];
+  uint32_t registered = 0;
+  for (uint32_t round = 0; round < 200; round++) {
+    uint32_t id = (round * 7) % (kSlots * 4);
+    snprintf(name, sizeof(name), "m%u", id);
+    if (live[id]) {
+      ASSERT_EQ(embedids_unregister_metric(&context, name), EMBEDIDS_OK);
+      live[id] = false;
+      registered--;
+    } else if (registered < kSlots) {
+      embedids_metric_config_t config = makeMetric(name, 0);
+      ASSERT_EQ(embedids_register_metric(&context, &config, nullptr), EMBEDIDS_OK);
+      live[id] = true;
+      registered++;
+    }
+
+    for (uint32_t check = 0; check < kSlots * 4; check++) {
+      snprintf(name, sizeof(name), "m%u", check);
+      embedids_result_t expected =
+          live[check] ? EMBEDIDS_OK : EMBEDIDS_ERROR_METRIC_NOT_FOUND;
+      ASSERT_EQ(addValue(name, check), expected) << "round " << round;
+    }
+  }
+  EXPECT_LE(system_config.num_active_metrics, kSlots);
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSRegistryTest, RejectsDuplicateLongAndOverCapacity) {
+  embedids_metric_config_t config = makeMetric("dup", 0);
+  ASSERT_EQ(embedids_register_metric(&context, &config, nullptr), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_register_metric(&context, &config, nullptr),
+            EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  memset(config.metric.name, 'x', EMBEDIDS_MAX_METRIC_NAME_LEN);
+  EXPECT_EQ(embedids_register_metric(&context, &config, nullptr),
+            EMBEDIDS_ERROR_METRIC_NAME_TOO_LONG);
+
+  config = makeMetric("no_history", 0);
+  config.metric.history = nullptr;
+  EXPECT_EQ(embedids_register_metric(&context, &config, nullptr),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+
+  for (uint32_t i = 1; i < kSlots; i++) {
+    char name[16];
+    snprintf(name, sizeof(name), "fill_%u", i);
+    config = makeMetric(name, i);
+    ASSERT_EQ(embedids_register_metric(&context, &config, nullptr), EMBEDIDS_OK);
+  }
+  config = makeMetric("one_too_many", 0);
+  EXPECT_EQ(embedids_register_metric(&context, &config, nullptr),
+            EMBEDIDS_ERROR_OUT_OF_MEMORY);
+}
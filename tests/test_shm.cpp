@@ -0,0 +1,377 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @brief Test fixture for shared-memory writer/analyzer segments
+ *
+ * Tests publication from the writer, read-only analysis on the shared
+ * rings and analysis while the writer keeps publishing.
+ */
+class EmbedIDSShmTest : public ::testing::Test {
+protected:
+  std::string shm_name;
+  embedids_metric_config_t layout[2];
+  embedids_shm_writer_t writer;
+  embedids_shm_analyzer_t analyzer;
+
+  void SetUp() override {
+    shm_name = "/embedids_test_" + std::to_string(getpid());
+    memset(layout, 0, sizeof(layout));
+    setupMetric(layout[0], nullptr, "cpu_usage", EMBEDIDS_METRIC_TYPE_FLOAT, 16);
+    setupMetric(layout[1], nullptr, "connections", EMBEDIDS_METRIC_TYPE_UINT32, 16);
+    memset(&writer, 0, sizeof(writer));
+    memset(&analyzer, 0, sizeof(analyzer));
+  }
+
+  void TearDown() override {
+    embedids_shm_analyzer_detach(&analyzer);
+    embedids_shm_writer_close(&writer);
+    shm_unlink(shm_name.c_str());
+  }
+
+  /**
+   * @brief Analyzer-side config: threshold on connections
+   */
+  void setupAnalyzerConfig(embedids_metric_config_t &config) {
+    setupMetric(config, nullptr, "connections", EMBEDIDS_METRIC_TYPE_UINT32, 0);
+    config.num_algorithms = 1;
+    config.algorithms[0].type = EMBEDIDS_ALGORITHM_THRESHOLD;
+    config.algorithms[0].enabled = true;
+    config.algorithms[0].config.threshold.max_threshold.u32 = 1000;
+    config.algorithms[0].config.threshold.check_max = true;
+  }
+
+  /**
+   * @brief Segment entry of a metric, as the writer laid it out
+   */
+  struct SegmentEntry {
+    char name[EMBEDIDS_MAX_METRIC_NAME_LEN];
+    uint32_t type;
+    uint32_t capacity;
+    uint64_t ring_offset;
+  };
+
+  SegmentEntry *segmentEntry(uint32_t slot) {
+    const size_t header_size = 32; // shm_header_t
+    return reinterpret_cast<SegmentEntry *>(static_cast<uint8_t *>(writer.base) + header_size) +
+           slot;
+  }
+
+  /**
+   * @brief Seqlock counter of a metric: twice the points, odd mid-write
+   */
+  std::atomic<uint64_t> *segmentSequence(uint32_t slot) {
+    const size_t counters = (32 + 2 * sizeof(SegmentEntry) + 63) / 64 * 64;
+    return reinterpret_cast<std::atomic<uint64_t> *>(static_cast<uint8_t *>(writer.base) +
+                                                     counters + 64 * slot);
+  }
+};
+
+/**
+ * @brief Writer activity injected into the middle of an analysis pass
+ */
+struct Interleave {
+  embedids_shm_writer_t *writer;
+  std::atomic<uint64_t> *sequence;
+  uint32_t points;    // Complete points to publish during the first call
+  bool leave_busy;    // Then mark the next point as being stored
+  uint32_t calls;
+};
+
+static Interleave interleave;
+
+static embedids_result_t interleaving_algorithm(const embedids_metric_t *metric,
+                                                const void *config, void *context) {
+  (void)metric;
+  (void)config;
+  (void)context;
+  if (interleave.calls++ == 0) {
+    embedids_metric_value_t value;
+    value.u32 = 1;
+    for (uint32_t i = 0; i < interleave.points; i++) {
+      embedids_shm_write(interleave.writer, 1, value, 100 + i);
+    }
+    if (interleave.leave_busy) {
+      interleave.sequence->fetch_add(1);
+    }
+  }
+  return EMBEDIDS_OK;
+}
+
+/**
+ * @brief Stream algorithm state that checks every delivered point is intact
+ */
+struct StreamAudit {
+  uint64_t next_timestamp;
+  uint64_t delivered;
+  uint64_t torn;
+};
+
+static embedids_result_t audit_stream(const embedids_metric_t *metric,
+                                      const embedids_datapoint_span_t *points,
+                                      const void *config, void *state) {
+  (void)metric;
+  (void)config;
+  StreamAudit *audit = static_cast<StreamAudit *>(state);
+  EMBEDIDS_SPAN_FOREACH(points, point) {
+    // The writer stores value = timestamp % 100; points only move forward
+    if (point->value.u32 != point->timestamp_ms % 100 ||
+        point->timestamp_ms < audit->next_timestamp) {
+      audit->torn++;
+    }
+    audit->next_timestamp = point->timestamp_ms + 1;
+    audit->delivered++;
+  }
+  return EMBEDIDS_OK;
+}
+
+// ============================================================================
+// Publication Tests
+// ============================================================================
+
+TEST_F(EmbedIDSShmTest, AnalyzerSeesPublishedPoints) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  uint32_t slot = 0;
+  ASSERT_EQ(embedids_shm_writer_find(&writer, "connections", &slot), EMBEDIDS_OK);
+  EXPECT_EQ(slot, 1u);
+
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+  EXPECT_EQ(config.metric.max_history_size, 16u);
+
+  embedids_metric_value_t value;
+  value.u32 = 10;
+  ASSERT_EQ(embedids_shm_write(&writer, slot, value, 1000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_OK);
+  EXPECT_EQ(config.metric.current_size, 1u);
+
+  value.u32 = 5000;
+  ASSERT_EQ(embedids_shm_write(&writer, slot, value, 2000), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+
+TEST_F(EmbedIDSShmTest, ViewLeavesGuardZone) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 1;
+  for (int i = 0; i < 40; i++) {
+    ASSERT_EQ(embedids_shm_write(&writer, 1, value, i), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_OK);
+  EXPECT_EQ(config.metric.current_size, 16u - EMBEDIDS_SHM_GUARD_POINTS);
+  EXPECT_EQ(config.metric.write_index, 40u % 16u);
+}
+
+TEST_F(EmbedIDSShmTest, TornViewCheckSitsOnTheGuardBoundary) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  config.algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  config.algorithms[0].config.custom.function = interleaving_algorithm;
+  config.algorithms[0].config.custom.config = nullptr;
+  config.algorithms[0].config.custom.context = nullptr;
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.u32 = 1;
+  for (int i = 0; i < 16; i++) {
+    ASSERT_EQ(embedids_shm_write(&writer, 1, value, i), EMBEDIDS_OK);
+  }
+
+  // Publishing exactly the guard zone reaches up to, not into, the oldest
+  // viewed slot, so the first pass stands
+  interleave = {&writer, segmentSequence(1), EMBEDIDS_SHM_GUARD_POINTS, false, 0};
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_OK);
+  EXPECT_EQ(interleave.calls, 1u);
+
+  // One more point still being stored lands on the oldest viewed slot, so
+  // the pass is repeated
+  interleave = {&writer, segmentSequence(1), EMBEDIDS_SHM_GUARD_POINTS, true, 0};
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_OK);
+  EXPECT_EQ(interleave.calls, 2u);
+  segmentSequence(1)->fetch_sub(1);
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSShmTest, AttachRejectsUnknownOrMismatchedMetric) {
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_NOT_INITIALIZED);
+
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  config.metric.type = EMBEDIDS_METRIC_TYPE_UINT64;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  layout[0].metric.max_history_size = EMBEDIDS_SHM_GUARD_POINTS;
+  embedids_shm_writer_t small;
+  EXPECT_EQ(embedids_shm_writer_create(&small, shm_name.c_str(), layout, 2),
+            EMBEDIDS_ERROR_CONFIG_INVALID);
+}
+
+TEST_F(EmbedIDSShmTest, AttachRejectsInconsistentSegment) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  SegmentEntry *entry = segmentEntry(1);
+  const SegmentEntry original = *entry;
+
+  entry->capacity = 0;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  entry->capacity = EMBEDIDS_SHM_GUARD_POINTS;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  entry->capacity = 1u << 30;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  *entry = original;
+  entry->ring_offset = UINT64_MAX - 8;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  entry->ring_offset = 0;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+
+  // Once attached, later changes to the entry are not read back
+  *entry = original;
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+  embedids_metric_value_t value;
+  value.u32 = 5000;
+  ASSERT_EQ(embedids_shm_write(&writer, 1, value, 1), EMBEDIDS_OK);
+  entry->capacity = 0;
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+  EXPECT_EQ(config.metric.max_history_size, 16u);
+}
+
+TEST_F(EmbedIDSShmTest, StatefulMetricsNeedPrivateHistory) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  embedids_alert_rule_t rule;
+  memset(&rule, 0, sizeof(rule));
+  rule.raise_after = 2;
+  embedids_alert_state_t alerts[1];
+  memset(alerts, 0, sizeof(alerts));
+  alerts[0].rule = &rule;
+
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  config.alerts = alerts;
+  EXPECT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  embedids_metric_datapoint_t history[8];
+  config.metric.history = history;
+  config.metric.max_history_size = 8;
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+  EXPECT_EQ(config.metric.history, history);
+  EXPECT_EQ(config.metric.max_history_size, 8u);
+
+  embedids_metric_value_t value;
+  value.u32 = 5000;
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(embedids_shm_write(&writer, 1, value, i), EMBEDIDS_OK);
+  }
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_OK);
+  EXPECT_EQ(config.metric.current_size, 8u);
+  EXPECT_EQ(history[7].timestamp_ms, 19u);
+  EXPECT_EQ(alerts[0].hits, 1u);
+
+  ASSERT_EQ(embedids_shm_write(&writer, 1, value, 20), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_ERROR_THRESHOLD_EXCEEDED);
+}
+
+TEST_F(EmbedIDSShmTest, AnalysisWhileWriterPublishes) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  embedids_metric_config_t config;
+  setupAnalyzerConfig(config);
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+
+  std::atomic<bool> stop{false};
+  std::thread producer([&] {
+    embedids_metric_value_t value;
+    uint64_t ts = 0;
+    while (!stop.load()) {
+      value.u32 = (uint32_t)(ts % 100);
+      embedids_shm_write(&writer, 1, value, ts++);
+    }
+  });
+
+  for (int i = 0; i < 1000; i++) {
+    embedids_result_t result = embedids_shm_analyze_all(&analyzer);
+    EXPECT_TRUE(result == EMBEDIDS_OK || result == EMBEDIDS_ERROR_THREAD_UNSAFE);
+  }
+  stop.store(true);
+  producer.join();
+}
+
+TEST_F(EmbedIDSShmTest, StreamSeesOnlyIntactPointsWhileWriterPublishes) {
+  ASSERT_EQ(embedids_shm_writer_create(&writer, shm_name.c_str(), layout, 2),
+            EMBEDIDS_OK);
+  StreamAudit audit = {0, 0, 0};
+  embedids_stream_instance_t instances[1] = {{&audit, 0}};
+  embedids_metric_datapoint_t history[12];
+
+  embedids_metric_config_t config;
+  setupMetric(config, history, "connections", EMBEDIDS_METRIC_TYPE_UINT32, 12);
+  config.num_algorithms = 1;
+  config.algorithms[0].type = EMBEDIDS_ALGORITHM_STREAM;
+  config.algorithms[0].enabled = true;
+  config.algorithms[0].config.stream.function = audit_stream;
+  config.stream_instances = instances;
+  ASSERT_EQ(embedids_shm_analyzer_attach(&analyzer, shm_name.c_str(), &config, 1),
+            EMBEDIDS_OK);
+
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> written{0};
+  std::thread producer([&] {
+    embedids_metric_value_t value;
+    uint64_t ts = 0;
+    while (!stop.load()) {
+      value.u32 = (uint32_t)(ts % 100);
+      embedids_shm_write(&writer, 1, value, ts++);
+      written.store(ts);
+    }
+  });
+
+  for (int i = 0; i < 1000 || written.load() < 1000; i++) {
+    embedids_result_t result = embedids_shm_analyze_all(&analyzer);
+    EXPECT_TRUE(result == EMBEDIDS_OK || result == EMBEDIDS_ERROR_THREAD_UNSAFE);
+  }
+  stop.store(true);
+  producer.join();
+
+  // Once the writer is quiet, a pass always gets an intact view
+  EXPECT_EQ(embedids_shm_analyze_all(&analyzer), EMBEDIDS_OK);
+  EXPECT_EQ(audit.torn, 0u);
+  EXPECT_GT(audit.delivered, 0u);
+}
@@ -0,0 +1,190 @@
+#include "embedids.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+/**
+ * @brief Test fixture for snapshot and restore of context state
+ *
+ * Tests round-tripping metric histories, custom algorithm state hooks,
+ * and rejection of corrupted or incompatible snapshots.
+ */
+class EmbedIDSSnapshotTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_metric_config_t metric_config;
+  embedids_metric_datapoint_t history_buffer[8];
+  embedids_system_config_t system_config;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(history_buffer, 0, sizeof(history_buffer));
+    memset(&metric_config, 0, sizeof(metric_config));
+    strncpy(metric_config.metric.name, "memory_usage",
+            EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+    metric_config.metric.type = EMBEDIDS_METRIC_TYPE_UINT32;
+    metric_config.metric.enabled = true;
+    metric_config.metric.history = history_buffer;
+    metric_config.metric.max_history_size = 8;
+
+    memset(&system_config, 0, sizeof(system_config));
+    system_config.metrics = &metric_config;
+    system_config.max_metrics = 1;
+    system_config.num_active_metrics = 1;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+  }
+
+  void TearDown() override { embedids_cleanup(&context); }
+
+  void addPoints(uint32_t count) {
+    embedids_metric_value_t value;
+    for (uint32_t i = 0; i < count; i++) {
+      value.u32 = 100 + i;
+      ASSERT_EQ(embedids_add_datapoint(&context, "memory_usage", value, 1000 * i),
+                EMBEDIDS_OK);
+    }
+  }
+
+  std::vector<uint8_t> takeSnapshot() {
+    size_t size = 0;
+    EXPECT_EQ(embedids_snapshot_size(&context, &size), EMBEDIDS_OK);
+    std::vector<uint8_t> blob(size);
+    EXPECT_EQ(embedids_snapshot(&context, blob.data(), blob.size()), EMBEDIDS_OK);
+    return blob;
+  }
+};
+
+/**
+ * @brief Custom algorithm whose state is a running counter
+ */
+typedef struct {
+  uint32_t samples_seen;
+} counter_state_t;
+
+static embedids_result_t counting_algorithm(const embedids_metric_t *metric,
+                                            const void *config, void *context) {
+  (void)metric;
+  (void)config;
+  static_cast<counter_state_t *>(context)->samples_seen++;
+  return EMBEDIDS_OK;
+}
+
+static size_t save_counter(const void *context, void *buffer, size_t size) {
+  if (buffer != nullptr && size >= sizeof(counter_state_t)) {
+    memcpy(buffer, context, sizeof(counter_state_t));
+  }
+  return sizeof(counter_state_t);
+}
+
+static embedids_result_t load_counter(void *context, const void *buffer,
+                                      size_t size) {
+  if (size != sizeof(counter_state_t)) {
+    return EMBEDIDS_ERROR_CONFIG_INVALID;
+  }
+  memcpy(context, buffer, size);
+  return EMBEDIDS_OK;
+}
+
+// ============================================================================
+// Round Trip Tests
+// ============================================================================
+
+TEST_F(EmbedIDSSnapshotTest, RestoresRingAndIndices) {
+  addPoints(11); // wraps the 8-entry ring
+  uint32_t write_index = metric_config.metric.write_index;
+  std::vector<uint8_t> blob = takeSnapshot();
+
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_EQ(metric_config.metric.current_size, 0u);
+  uint32_t epoch = context.epoch;
+
+  ASSERT_EQ(embedids_restore(&context, blob.data(), blob.size()), EMBEDIDS_OK);
+  EXPECT_NE(context.epoch, epoch); // Replaced points count as discarded
+  EXPECT_EQ(metric_config.metric.current_size, 8u);
+  EXPECT_EQ(metric_config.metric.write_index, write_index);
+  uint32_t latest = (write_index + 7) % 8;
+  EXPECT_EQ(history_buffer[latest].value.u32, 110u);
+}
+
+TEST_F(EmbedIDSSnapshotTest, CustomStateHooksRoundTrip) {
+  counter_state_t state = {0};
+  metric_config.num_algorithms = 1;
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  metric_config.algorithms[0].enabled = true;
+  metric_config.algorithms[0].config.custom.function = counting_algorithm;
+  metric_config.algorithms[0].config.custom.context = &state;
+  metric_config.algorithms[0].config.custom.save = save_counter;
+  metric_config.algorithms[0].config.custom.load = load_counter;
+
+  addPoints(3);
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(embedids_analyze_metric(&context, "memory_usage"), EMBEDIDS_OK);
+  }
+  std::vector<uint8_t> blob = takeSnapshot();
+
+  state.samples_seen = 0;
+  ASSERT_EQ(embedids_restore(&context, blob.data(), blob.size()), EMBEDIDS_OK);
+  EXPECT_EQ(state.samples_seen, 5u);
+}
+
+static embedids_result_t refuse_load(void *context, const void *buffer, size_t size) {
+  (void)context;
+  (void)buffer;
+  (void)size;
+  return EMBEDIDS_ERROR_ALGORITHM_FAILED;
+}
+
+TEST_F(EmbedIDSSnapshotTest, FailingLoadHookLeavesHistoryUntouched) {
+  counter_state_t state = {0};
+  metric_config.num_algorithms = 1;
+  metric_config.algorithms[0].type = EMBEDIDS_ALGORITHM_CUSTOM;
+  metric_config.algorithms[0].enabled = true;
+  metric_config.algorithms[0].config.custom.function = counting_algorithm;
+  metric_config.algorithms[0].config.custom.context = &state;
+  metric_config.algorithms[0].config.custom.save = save_counter;
+  metric_config.algorithms[0].config.custom.load = refuse_load;
+
+  addPoints(6);
+  std::vector<uint8_t> blob = takeSnapshot();
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  addPoints(2);
+  uint32_t epoch = context.epoch;
+
+  EXPECT_EQ(embedids_restore(&context, blob.data(), blob.size()),
+            EMBEDIDS_ERROR_ALGORITHM_FAILED);
+  EXPECT_EQ(metric_config.metric.current_size, 2u);
+  EXPECT_EQ(history_buffer[1].value.u32, 101u);
+  EXPECT_EQ(context.epoch, epoch);
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSSnapshotTest, RejectsSmallBuffer) {
+  size_t size = 0;
+  ASSERT_EQ(embedids_snapshot_size(&context, &size), EMBEDIDS_OK);
+  std::vector<uint8_t> blob(size - 1);
+  EXPECT_EQ(embedids_snapshot(&context, blob.data(), blob.size()),
+            EMBEDIDS_ERROR_BUFFER_FULL);
+}
+
+TEST_F(EmbedIDSSnapshotTest, RejectsCorruptedBlobWithoutModifyingState) {
+  addPoints(4);
+  std::vector<uint8_t> blob = takeSnapshot();
+  blob[blob.size() - 3] ^= 0xff;
+
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_restore(&context, blob.data(), blob.size()),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  EXPECT_EQ(metric_config.metric.current_size, 0u);
+}
+
+TEST_F(EmbedIDSSnapshotTest, RejectsIncompatibleMetric) {
+  addPoints(2);
+  std::vector<uint8_t> blob = takeSnapshot();
+
+  metric_config.metric.type = EMBEDIDS_METRIC_TYPE_FLOAT;
+  EXPECT_EQ(embedids_restore(&context, blob.data(), blob.size()),
+            EMBEDIDS_ERROR_CONFIG_INVALID);
+}
@@ -0,0 +1,262 @@
+#include "embedids.h"
+#include "test_helpers.h"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+/**
+ * @brief Test fixture for binary trace capture and replay
+ *
+ * Tests recording through the ingest hook, reading a mapped capture,
+ * time-based seeking through the footer index and replay into a context.
+ */
+class EmbedIDSTraceTest : public ::testing::Test {
+protected:
+  embedids_context_t context;
+  embedids_metric_config_t metric_configs[2];
+  embedids_metric_datapoint_t cpu_history[16];
+  embedids_metric_datapoint_t net_history[16];
+  embedids_system_config_t system_config;
+  FILE *file = nullptr;
+
+  void SetUp() override {
+    memset(&context, 0, sizeof(context));
+    memset(metric_configs, 0, sizeof(metric_configs));
+    setupMetric(metric_configs[0], cpu_history, "cpu_usage", EMBEDIDS_METRIC_TYPE_FLOAT, 16);
+    setupMetric(metric_configs[1], net_history, "net_packets", EMBEDIDS_METRIC_TYPE_UINT32,
+                16);
+
+    memset(&system_config, 0, sizeof(system_config));
+    system_config.metrics = metric_configs;
+    system_config.max_metrics = 2;
+    system_config.num_active_metrics = 2;
+    ASSERT_EQ(embedids_init(&context, &system_config), EMBEDIDS_OK);
+
+    file = tmpfile();
+    ASSERT_NE(file, nullptr);
+  }
+
+  void TearDown() override {
+    embedids_cleanup(&context);
+    if (file) {
+      fclose(file);
+    }
+  }
+};
+
+// ============================================================================
+// Recording Tests
+// ============================================================================
+
+TEST_F(EmbedIDSTraceTest, RecordAndReadBack) {
+  embedids_trace_writer_t writer;
+  embedids_trace_index_entry_t index[8];
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, index, 8),
+            EMBEDIDS_OK);
+  ASSERT_EQ(embedids_trace_attach(&context, &writer), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  value.f32 = 42.5f;
+  EXPECT_EQ(embedids_add_datapoint(&context, "cpu_usage", value, 1000), EMBEDIDS_OK);
+  value.u32 = 7;
+  EXPECT_EQ(embedids_add_datapoint(&context, "net_packets", value, 1001), EMBEDIDS_OK);
+
+  ASSERT_EQ(embedids_trace_writer_close(&writer), EMBEDIDS_OK);
+  EXPECT_EQ(writer.record_count, 2u);
+
+  embedids_trace_reader_t reader;
+  ASSERT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_OK);
+  EXPECT_TRUE(reader.complete);
+  ASSERT_EQ(reader.num_metrics, 2u);
+  EXPECT_STREQ(reader.metrics[0].name, "cpu_usage");
+  EXPECT_STREQ(reader.metrics[1].name, "net_packets");
+  ASSERT_EQ(reader.record_count, 2u);
+  EXPECT_EQ(reader.records[0].metric_index, 0);
+  EXPECT_FLOAT_EQ(reader.records[0].value.f32, 42.5f);
+  EXPECT_EQ(reader.records[1].metric_index, 1);
+  EXPECT_EQ(reader.records[1].value.u32, 7u);
+  EXPECT_EQ(reader.records[1].timestamp_ms, 1001u);
+  embedids_trace_reader_close(&reader);
+}
+
+TEST_F(EmbedIDSTraceTest, IndexCompactsAndSeekFindsTimestamp) {
+  embedids_trace_writer_t writer;
+  embedids_trace_index_entry_t index[4];
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, index, 4),
+            EMBEDIDS_OK);
+
+  // Enough records to overflow the index several times
+  const uint32_t total = EMBEDIDS_TRACE_INDEX_STRIDE * 10;
+  embedids_metric_datapoint_t datapoint;
+  memset(&datapoint, 0, sizeof(datapoint));
+  for (uint32_t i = 0; i < total; i++) {
+    datapoint.timestamp_ms = 10 * i;
+    datapoint.value.u32 = i;
+    ASSERT_EQ(embedids_trace_writer_append(&writer, 1, &datapoint), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(embedids_trace_writer_close(&writer), EMBEDIDS_OK);
+  EXPECT_LE(writer.index_count, 4u);
+  EXPECT_GT(writer.index_stride, (uint32_t)EMBEDIDS_TRACE_INDEX_STRIDE);
+
+  embedids_trace_reader_t reader;
+  ASSERT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_OK);
+  ASSERT_EQ(reader.record_count, total);
+  EXPECT_GT(reader.index_count, 0u);
+
+  uint64_t position = 0;
+  EXPECT_EQ(embedids_trace_reader_seek(&reader, 12345, &position), EMBEDIDS_OK);
+  EXPECT_EQ(position, 1235u);
+  EXPECT_EQ(embedids_trace_reader_seek(&reader, 0, &position), EMBEDIDS_OK);
+  EXPECT_EQ(position, 0u);
+  EXPECT_EQ(embedids_trace_reader_seek(&reader, 10 * total, &position), EMBEDIDS_OK);
+  EXPECT_EQ(position, total);
+  embedids_trace_reader_close(&reader);
+}
+
+TEST_F(EmbedIDSTraceTest, UnterminatedCaptureIsReadable) {
+  embedids_trace_writer_t writer;
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, nullptr, 0),
+            EMBEDIDS_OK);
+
+  embedids_metric_datapoint_t datapoint;
+  memset(&datapoint, 0, sizeof(datapoint));
+  for (uint32_t i = 0; i < 3; i++) {
+    datapoint.timestamp_ms = i;
+    ASSERT_EQ(embedids_trace_writer_append(&writer, 0, &datapoint), EMBEDIDS_OK);
+  }
+  // Simulate a crash: records reach the file but no footer is written
+  ASSERT_EQ(embedids_trace_writer_flush(&writer), EMBEDIDS_OK);
+
+  embedids_trace_reader_t reader;
+  ASSERT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_OK);
+  EXPECT_FALSE(reader.complete);
+  EXPECT_EQ(reader.record_count, 3u);
+  EXPECT_EQ(reader.index_count, 0u);
+  embedids_trace_reader_close(&reader);
+}
+
+TEST_F(EmbedIDSTraceTest, AttachedWriterPinsSlots) {
+  embedids_trace_writer_t writer;
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, nullptr, 0),
+            EMBEDIDS_OK);
+  ASSERT_EQ(embedids_trace_attach(&context, &writer), EMBEDIDS_OK);
+
+  // Records name slots from the table in the header, which is already written
+  embedids_metric_config_t extra = metric_configs[1];
+  strncpy(extra.metric.name, "disk_io", EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+  EXPECT_EQ(embedids_unregister_metric(&context, "cpu_usage"), EMBEDIDS_ERROR_CONFIG_INVALID);
+  EXPECT_EQ(embedids_register_metric(&context, &extra, nullptr), EMBEDIDS_ERROR_CONFIG_INVALID);
+
+  ASSERT_EQ(embedids_trace_attach(&context, nullptr), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_unregister_metric(&context, "cpu_usage"), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_trace_writer_close(&writer), EMBEDIDS_OK);
+
+  // A writer whose table misses a metric cannot be attached
+  embedids_trace_writer_t small;
+  ASSERT_EQ(embedids_unregister_metric(&context, "net_packets"), EMBEDIDS_OK);
+  system_config.num_active_metrics = 0;
+  ASSERT_EQ(embedids_trace_writer_open(&small, fileno(file), &context, nullptr, 0),
+            EMBEDIDS_OK);
+  system_config.num_active_metrics = 2;
+  EXPECT_EQ(embedids_trace_attach(&context, &small), EMBEDIDS_ERROR_CONFIG_INVALID);
+  EXPECT_FALSE(context.slots_pinned);
+}
+
+// ============================================================================
+// Replay and Validation Tests
+// ============================================================================
+
+TEST_F(EmbedIDSTraceTest, ReplayIntoContext) {
+  embedids_trace_writer_t writer;
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, nullptr, 0),
+            EMBEDIDS_OK);
+  ASSERT_EQ(embedids_trace_attach(&context, &writer), EMBEDIDS_OK);
+
+  embedids_metric_value_t value;
+  for (uint32_t i = 0; i < 5; i++) {
+    value.u32 = i * 100;
+    ASSERT_EQ(embedids_add_datapoint(&context, "net_packets", value, i), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(embedids_trace_attach(&context, nullptr), EMBEDIDS_OK);
+  ASSERT_EQ(embedids_trace_writer_close(&writer), EMBEDIDS_OK);
+
+  ASSERT_EQ(embedids_reset_all_metrics(&context), EMBEDIDS_OK);
+  EXPECT_EQ(metric_configs[1].metric.current_size, 0u);
+
+  embedids_trace_reader_t reader;
+  ASSERT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_OK);
+  EXPECT_EQ(embedids_trace_replay(&reader, &context, 0, reader.record_count),
+            EMBEDIDS_OK);
+  EXPECT_EQ(metric_configs[1].metric.current_size, 5u);
+  EXPECT_EQ(net_history[4].value.u32, 400u);
+
+  EXPECT_EQ(embedids_trace_replay(&reader, &context, 4, 2),
+            EMBEDIDS_ERROR_INVALID_PARAM);
+  embedids_trace_reader_close(&reader);
+}
+
+TEST_F(EmbedIDSTraceTest, RejectsForeignFile) {
+  const char junk[128] = "definitely not a trace";
+  ASSERT_EQ(write(fileno(file), junk, sizeof(junk)), (ssize_t)sizeof(junk));
+
+  embedids_trace_reader_t reader;
+  EXPECT_EQ(embedids_trace_reader_open(&reader, fileno(file)),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSTraceTest, RejectsWrappingMetricCount) {
+  embedids_trace_writer_t writer;
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, nullptr, 0),
+            EMBEDIDS_OK);
+  ASSERT_EQ(embedids_trace_writer_close(&writer), EMBEDIDS_OK);
+
+  // A count whose table size wraps to the real one in 32 bits
+  const uint32_t entry = sizeof(embedids_trace_metric_entry_t);
+  uint32_t count = 2u + (uint32_t)((1ull << 32) / (entry & (0u - entry)));
+  ASSERT_EQ(pwrite(fileno(file), &count, sizeof(count), 12), (ssize_t)sizeof(count));
+
+  embedids_trace_reader_t reader;
+  EXPECT_EQ(embedids_trace_reader_open(&reader, fileno(file)),
+            EMBEDIDS_ERROR_BUFFER_CORRUPT);
+}
+
+TEST_F(EmbedIDSTraceTest, RejectsHostileFooter) {
+  embedids_trace_writer_t writer;
+  embedids_trace_index_entry_t index[4];
+  ASSERT_EQ(embedids_trace_writer_open(&writer, fileno(file), &context, index, 4),
+            EMBEDIDS_OK);
+  embedids_metric_datapoint_t datapoint;
+  memset(&datapoint, 0, sizeof(datapoint));
+  for (uint32_t i = 0; i < 3; i++) {
+    datapoint.timestamp_ms = i;
+    ASSERT_EQ(embedids_trace_writer_append(&writer, 0, &datapoint), EMBEDIDS_OK);
+  }
+  ASSERT_EQ(embedids_trace_writer_close(&writer), EMBEDIDS_OK);
+  ASSERT_EQ(writer.index_count, 1u);
+
+  off_t size = lseek(fileno(file), 0, SEEK_END);
+  off_t footer = size - 32;
+  off_t entry = footer - (off_t)sizeof(embedids_trace_index_entry_t);
+  embedids_trace_reader_t reader;
+
+  // An index entry past the last record would bound a seek outside the file
+  uint64_t record = 4;
+  ASSERT_EQ(pwrite(fileno(file), &record, sizeof(record), entry + 8), (ssize_t)sizeof(record));
+  EXPECT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_ERROR_BUFFER_CORRUPT);
+  record = 0;
+  ASSERT_EQ(pwrite(fileno(file), &record, sizeof(record), entry + 8), (ssize_t)sizeof(record));
+  ASSERT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_OK);
+  EXPECT_TRUE(reader.complete);
+  embedids_trace_reader_close(&reader);
+
+  // A record count whose byte size wraps 64 bits back to the real offset
+  uint64_t count = 3 + (1ull << 61);
+  ASSERT_EQ(pwrite(fileno(file), &count, sizeof(count), footer), (ssize_t)sizeof(count));
+  ASSERT_EQ(embedids_trace_reader_open(&reader, fileno(file)), EMBEDIDS_OK);
+  EXPECT_FALSE(reader.complete);
+  EXPECT_LT(reader.record_count, 8u);
+  uint64_t position = 0;
+  EXPECT_EQ(embedids_trace_reader_seek(&reader, 2, &position), EMBEDIDS_OK);
+  embedids_trace_reader_close(&reader);
+}
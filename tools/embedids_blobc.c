@@ -0,0 +1,393 @@
+/*
+ * Copyright 2025 Seyed Amir Alavi and Mahyar Abbaspour
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @brief Compile a declarative metric configuration into a config blob
+ *
+ * Usage: embedids_blobc [-n symbol] <input.conf> <output>
+ *
+ * The output is the raw blob, or a C header defining an aligned byte
+ * array when the output name ends in ".h". Input is line oriented; '#'
+ * starts a comment:
+ *
+ *   metric <name> <type> <history_size> [disabled]
+ *   threshold [min <value>] [max <value>]
+ *   trend window <points> [slope <f>] [variance <f>]
+ *         [expected stable|increasing|decreasing]
+ *
+ * Types: uint32 uint64 float double percentage rate bool enum. Algorithm
+ * lines apply to the preceding metric.
+ *
+ * The blob stores structs in this build's layout; build the tool with the
+ * same EMBEDIDS_* configuration and ABI as the target.
+ */
+
+#include <embedids.h>
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE 256
+#define MAX_TOKENS 16
+
+typedef struct {
+  const char *name;
+  embedids_metric_type_t type;
+} type_name_t;
+
+static const type_name_t type_names[] = {
+    {"uint32", EMBEDIDS_METRIC_TYPE_UINT32},
+    {"uint64", EMBEDIDS_METRIC_TYPE_UINT64},
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+    {"float", EMBEDIDS_METRIC_TYPE_FLOAT},
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+    {"double", EMBEDIDS_METRIC_TYPE_DOUBLE},
+#endif
+    {"percentage", EMBEDIDS_METRIC_TYPE_PERCENTAGE},
+    {"rate", EMBEDIDS_METRIC_TYPE_RATE},
+#endif
+    {"bool", EMBEDIDS_METRIC_TYPE_BOOL},
+    {"enum", EMBEDIDS_METRIC_TYPE_ENUM},
+};
+
+static embedids_metric_config_t metrics[EMBEDIDS_MAX_METRICS];
+static uint32_t num_metrics;
+
+static int fail(const char *path, unsigned line, const char *message) {
+  fprintf(stderr, "%s:%u: %s\n", path, line, message);
+  return -1;
+}
+
+/* Whole-token unsigned number no larger than max; no sign, no wrapping */
+static int parse_unsigned(const char *text, uint64_t max, uint64_t *value) {
+  char *end = NULL;
+  errno = 0;
+  unsigned long long parsed = strtoull(text, &end, 0);
+  if (text[0] == '-' || end == text || *end != '\0' || errno == ERANGE || parsed > max) {
+    return -1;
+  }
+  *value = parsed;
+  return 0;
+}
+
+/* Whole-token finite number */
+static int parse_double(const char *text, double *value) {
+  char *end = NULL;
+  double parsed = strtod(text, &end);
+  if (end == text || *end != '\0' || !isfinite(parsed)) {
+    return -1;
+  }
+  *value = parsed;
+  return 0;
+}
+
+static int parse_float(const char *text, float *value) {
+  double parsed = 0.0;
+  if (parse_double(text, &parsed) != 0 || fabs(parsed) > FLT_MAX) {
+    return -1; // Would not fit a float
+  }
+  *value = (float)parsed;
+  return 0;
+}
+
+static int parse_value(embedids_metric_type_t type, const char *text,
+                       embedids_metric_value_t *value) {
+  uint64_t number = 0;
+  memset(value, 0, sizeof(*value));
+  switch (type) {
+  case EMBEDIDS_METRIC_TYPE_UINT32:
+    if (parse_unsigned(text, UINT32_MAX, &number) != 0) {
+      return -1;
+    }
+    value->u32 = (uint32_t)number;
+    return 0;
+  case EMBEDIDS_METRIC_TYPE_UINT64:
+    return parse_unsigned(text, UINT64_MAX, &value->u64);
+#if EMBEDIDS_ENABLE_FLOATING_POINT
+  case EMBEDIDS_METRIC_TYPE_FLOAT:
+  case EMBEDIDS_METRIC_TYPE_PERCENTAGE:
+  case EMBEDIDS_METRIC_TYPE_RATE:
+    return parse_float(text, &value->f32);
+#if EMBEDIDS_ENABLE_DOUBLE_PRECISION
+  case EMBEDIDS_METRIC_TYPE_DOUBLE:
+    return parse_double(text, &value->f64);
+#endif
+#endif
+  case EMBEDIDS_METRIC_TYPE_BOOL:
+    value->boolean = strcmp(text, "true") == 0 || strcmp(text, "1") == 0;
+    return (value->boolean || strcmp(text, "false") == 0 || strcmp(text, "0") == 0)
+               ? 0
+               : -1;
+  case EMBEDIDS_METRIC_TYPE_ENUM:
+    if (parse_unsigned(text, UINT8_MAX, &number) != 0) {
+      return -1;
+    }
+    value->enum_val = (uint8_t)number;
+    return 0;
+  default:
+    return -1;
+  }
+}
+
+static int parse_metric(char **tokens, int count, const char *path, unsigned line) {
+  if (count < 4 || count > 5 || (count == 5 && strcmp(tokens[4], "disabled") != 0)) {
+    return fail(path, line, "expected: metric <name> <type> <history_size> [disabled]");
+  }
+  if (num_metrics == EMBEDIDS_MAX_METRICS) {
+    return fail(path, line, "too many metrics for EMBEDIDS_MAX_METRICS");
+  }
+  if (strlen(tokens[1]) >= EMBEDIDS_MAX_METRIC_NAME_LEN) {
+    return fail(path, line, "metric name too long");
+  }
+  for (uint32_t i = 0; i < num_metrics; i++) {
+    if (strcmp(metrics[i].metric.name, tokens[1]) == 0) {
+      return fail(path, line, "duplicate metric name");
+    }
+  }
+
+  embedids_metric_config_t *config = &metrics[num_metrics];
+  memset(config, 0, sizeof(*config));
+  strncpy(config->metric.name, tokens[1], EMBEDIDS_MAX_METRIC_NAME_LEN - 1);
+
+  size_t t = 0;
+  while (t < sizeof(type_names) / sizeof(type_names[0]) &&
+         strcmp(type_names[t].name, tokens[2]) != 0) {
+    t++;
+  }
+  if (t == sizeof(type_names) / sizeof(type_names[0])) {
+    return fail(path, line, "unknown metric type");
+  }
+  config->metric.type = type_names[t].type;
+
+  uint64_t size = 0;
+  if (parse_unsigned(tokens[3], UINT32_MAX, &size) != 0 || size == 0) {
+    return fail(path, line, "invalid history size");
+  }
+  config->metric.max_history_size = (uint32_t)size;
+  config->metric.enabled = count < 5;
+  num_metrics++;
+  return 0;
+}
+
+static embedids_algorithm_t *add_algorithm(const char *path, unsigned line) {
+  if (num_metrics == 0) {
+    fail(path, line, "algorithm before any metric");
+    return NULL;
+  }
+  embedids_metric_config_t *config = &metrics[num_metrics - 1];
+  if (config->num_algorithms == EMBEDIDS_MAX_ALGORITHMS_PER_METRIC) {
+    fail(path, line, "too many algorithms for this metric");
+    return NULL;
+  }
+  embedids_algorithm_t *algorithm = &config->algorithms[config->num_algorithms++];
+  algorithm->enabled = true;
+  return algorithm;
+}
+
+static int parse_threshold(char **tokens, int count, const char *path, unsigned line) {
+  embedids_algorithm_t *algorithm = add_algorithm(path, line);
+  if (algorithm == NULL) {
+    return -1;
+  }
+  algorithm->type = EMBEDIDS_ALGORITHM_THRESHOLD;
+  embedids_metric_type_t type = metrics[num_metrics - 1].metric.type;
+  embedids_threshold_config_t *threshold = &algorithm->config.threshold;
+
+  if (count < 3 || count % 2 == 0) {
+    return fail(path, line, "expected: threshold [min <value>] [max <value>]");
+  }
+  for (int i = 1; i < count; i += 2) {
+    if (strcmp(tokens[i], "min") == 0 &&
+        parse_value(type, tokens[i + 1], &threshold->min_threshold) == 0) {
+      threshold->check_min = true;
+    } else if (strcmp(tokens[i], "max") == 0 &&
+               parse_value(type, tokens[i + 1], &threshold->max_threshold) == 0) {
+      threshold->check_max = true;
+    } else {
+      return fail(path, line, "invalid threshold bound");
+    }
+  }
+  return 0;
+}
+
+static int parse_trend(char **tokens, int count, const char *path, unsigned line) {
+  embedids_algorithm_t *algorithm = add_algorithm(path, line);
+  if (algorithm == NULL) {
+    return -1;
+  }
+  algorithm->type = EMBEDIDS_ALGORITHM_TREND;
+  embedids_trend_config_t *trend = &algorithm->config.trend;
+
+  if (count % 2 == 0) {
+    return fail(path, line, "trend options come in <key> <value> pairs");
+  }
+  for (int i = 1; i < count; i += 2) {
+    const char *key = tokens[i];
+    const char *value = tokens[i + 1];
+    uint64_t window = 0;
+    if (strcmp(key, "window") == 0) {
+      if (parse_unsigned(value, UINT32_MAX, &window) != 0) {
+        return fail(path, line, "invalid trend window");
+      }
+      trend->window_size = (uint32_t)window;
+    } else if (strcmp(key, "slope") == 0) {
+      if (parse_float(value, &trend->max_slope) != 0) {
+        return fail(path, line, "invalid trend slope");
+      }
+    } else if (strcmp(key, "variance") == 0) {
+      if (parse_float(value, &trend->max_variance) != 0) {
+        return fail(path, line, "invalid trend variance");
+      }
+    } else if (strcmp(key, "expected") == 0 && strcmp(value, "stable") == 0) {
+      trend->expected_trend = EMBEDIDS_TREND_STABLE;
+    } else if (strcmp(key, "expected") == 0 && strcmp(value, "increasing") == 0) {
+      trend->expected_trend = EMBEDIDS_TREND_INCREASING;
+    } else if (strcmp(key, "expected") == 0 && strcmp(value, "decreasing") == 0) {
+      trend->expected_trend = EMBEDIDS_TREND_DECREASING;
+    } else {
+      return fail(path, line, "unknown trend option");
+    }
+  }
+  if (trend->window_size < 2) {
+    return fail(path, line, "trend window must be at least 2");
+  }
+  return 0;
+}
+
+static int parse_file(const char *path) {
+  FILE *input = fopen(path, "r");
+  if (input == NULL) {
+    perror(path);
+    return -1;
+  }
+
+  char text[MAX_LINE];
+  unsigned line = 0;
+  int status = 0;
+  while (status == 0 && fgets(text, sizeof(text), input) != NULL) {
+    line++;
+    if (strchr(text, '\n') == NULL && !feof(input)) {
+      status = fail(path, line, "line too long");
+      break;
+    }
+    char *comment = strchr(text, '#');
+    if (comment != NULL) {
+      *comment = '\0';
+    }
+
+    char *tokens[MAX_TOKENS];
+    int count = 0;
+    char *token = strtok(text, " \t\r\n");
+    for (; token != NULL && count < MAX_TOKENS; token = strtok(NULL, " \t\r\n")) {
+      tokens[count++] = token;
+    }
+    if (token != NULL) {
+      status = fail(path, line, "too many tokens");
+      break;
+    }
+    if (count == 0) {
+      continue;
+    }
+
+    if (strcmp(tokens[0], "metric") == 0) {
+      status = parse_metric(tokens, count, path, line);
+    } else if (strcmp(tokens[0], "threshold") == 0) {
+      status = parse_threshold(tokens, count, path, line);
+    } else if (strcmp(tokens[0], "trend") == 0) {
+      status = parse_trend(tokens, count, path, line);
+    } else {
+      status = fail(path, line, "unknown directive");
+    }
+  }
+
+  fclose(input);
+  if (status == 0 && num_metrics == 0) {
+    fprintf(stderr, "%s: no metrics defined\n", path);
+    return -1;
+  }
+  return status;
+}
+
+static int write_header(FILE *output, const char *symbol, const uint8_t *blob,
+                        size_t size) {
+  fprintf(output, "/* Generated by embedids_blobc; do not edit */\n\n");
+  fprintf(output, "#include <embedids.h>\n\n");
+  fprintf(output, "/* Writable: ring state lives in the blob after init */\n");
+  fprintf(output, "static uint8_t %s[%zu]\n", symbol, size);
+  fprintf(output, "    __attribute__((aligned(EMBEDIDS_CONFIG_BLOB_ALIGNMENT))) = {");
+  for (size_t i = 0; i < size; i++) {
+    fprintf(output, "%s0x%02x,", i % 12 == 0 ? "\n    " : " ", blob[i]);
+  }
+  fprintf(output, "\n};\n");
+  return ferror(output) ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+  const char *symbol = "embedids_config_blob";
+  int arg = 1;
+  if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+    symbol = argv[2];
+    arg = 3;
+  }
+  if (argc - arg != 2) {
+    fprintf(stderr, "usage: %s [-n symbol] <input.conf> <output>\n", argv[0]);
+    return 2;
+  }
+  const char *input_path = argv[arg];
+  const char *output_path = argv[arg + 1];
+
+  if (parse_file(input_path) != 0) {
+    return 1;
+  }
+
+  size_t size = 0;
+  embedids_result_t result = embedids_config_to_blob(metrics, num_metrics, NULL, 0, &size);
+  uint8_t *blob = result == EMBEDIDS_OK ? malloc(size) : NULL;
+  if (blob != NULL) {
+    result = embedids_config_to_blob(metrics, num_metrics, blob, size, &size);
+  }
+  if (result != EMBEDIDS_OK || blob == NULL) {
+    fprintf(stderr, "%s: %s\n", input_path,
+            blob ? embedids_get_error_string(result) : "out of memory");
+    free(blob);
+    return 1;
+  }
+
+  size_t len = strlen(output_path);
+  bool as_header = len > 2 && strcmp(output_path + len - 2, ".h") == 0;
+  FILE *output = fopen(output_path, as_header ? "w" : "wb");
+  if (output == NULL) {
+    perror(output_path);
+    free(blob);
+    return 1;
+  }
+
+  int status = as_header ? write_header(output, symbol, blob, size)
+                         : (fwrite(blob, 1, size, output) == size ? 0 : -1);
+  if (fclose(output) != 0 || status != 0) {
+    fprintf(stderr, "%s: write failed\n", output_path);
+    status = -1;
+  }
+  free(blob);
+
+  if (status == 0) {
+    printf("%s: %u metrics, %zu bytes\n", output_path, num_metrics, size);
+  }
+  return status == 0 ? 0 : 1;
+}